@@ -5,8 +5,20 @@
 #include <random>
 #include <algorithm>
 #include <type_traits>
+#include <string>
+#include <filesystem>
+#include <fstream>
+
+#if defined(__unix__)
+   #include <fcntl.h>
+   #include <sys/mman.h>
+   #include <unistd.h>
+#endif
 
 #include "mmoore/monkey_moore.hpp"
+#include "mmoore/multi_monkey_moore.hpp"
+#include "mmoore/search_engine.hpp"
+#include "mmoore/cpu_dispatch.hpp"
 
 template<typename DataType>
 static std::vector<DataType> generate_data(size_t size_in_bytes) {
@@ -21,13 +33,73 @@ static std::vector<DataType> generate_data(size_t size_in_bytes) {
    return data;
 }
 
+static std::vector<std::vector<CharType>> generate_keywords(size_t count, bool wildcards = false) {
+   std::vector<std::vector<CharType>> keywords(count);
+   std::mt19937 rng(7);
+   std::uniform_int_distribution<int> length_dist(5, 10);
+   std::uniform_int_distribution<int> letter_dist('a', 'z');
+
+   for (auto &keyword : keywords) {
+      keyword.resize(length_dist(rng));
+      std::generate(keyword.begin(), keyword.end(), [&]() { return static_cast<CharType>(letter_dist(rng)); });
+
+      if (wildcards) {
+         keyword[2] = '*';
+      }
+   }
+
+   return keywords;
+}
+
+// low entropy data: long runs of the same value, broken by values the periodic keywords
+// never match, so the timings measure the shifts rather than the reported matches
+template<typename DataType>
+static std::vector<DataType> generate_repetitive_data(size_t size_in_bytes) {
+   std::vector<DataType> data(size_in_bytes / sizeof(DataType));
+   std::mt19937 rng(42);
+   std::uniform_int_distribution<int> dist(0, 63);
+
+   for (auto &v : data) {
+      v = static_cast<DataType>(dist(rng) == 0 ? 'z' : 'a');
+   }
+
+   return data;
+}
+
+// text-like data: lowercase letters with English frequencies and spaces between words,
+// so small relative differences are as common as they are in real scripts
 template<typename DataType>
+static std::vector<DataType> generate_text_data(size_t size_in_bytes) {
+   static const char letters[] = "etaoinshrdlcumwfgypbvkjxqz";
+   static const double frequencies[] = {
+      12.7, 9.1, 8.2, 7.5, 7.0, 6.7, 6.3, 6.1, 6.0, 4.3, 4.0, 2.8, 2.8, 
+      2.4, 2.4, 2.2, 2.0, 2.0, 1.9, 1.5, 1.0, 0.8, 0.2, 0.2, 0.1, 0.1
+   };
+
+   std::vector<DataType> data(size_in_bytes / sizeof(DataType));
+   std::mt19937 rng(42);
+   std::discrete_distribution<int> letter_dist(std::begin(frequencies), std::end(frequencies));
+   std::uniform_int_distribution<int> space_dist(0, 5);
+
+   for (auto &v : data) {
+      v = static_cast<DataType>(space_dist(rng) == 0 ? ' ' : letters[letter_dist(rng)]);
+   }
+
+   return data;
+}
+
+template<typename DataType, SearchAlgorithm Algorithm>
 static void BM_MonkeyMoore_Relative(benchmark::State &state) {
    const size_t buffer_size_bytes = state.range(0);
    auto data = generate_data<DataType>(buffer_size_bytes);
 
    std::vector<CharType> keyword = { 'a', 'b', 'c', 'd', 'e' };
    MonkeyMoore<DataType> searcher(keyword, 0, {});
+   searcher.set_algorithm(Algorithm);
+
+   if (Algorithm != SearchAlgorithm::BoyerMoore) {
+      state.SetLabel(mmoore::to_string(mmoore::resolve_instruction_set()));
+   }
 
    for (auto _ : state) {
       auto results = searcher.search(data.data(), data.size());
@@ -37,7 +109,7 @@ static void BM_MonkeyMoore_Relative(benchmark::State &state) {
    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(data.size()) * sizeof(DataType));
 }
 
-template<typename DataType, int WildcardPos>
+template<typename DataType, int WildcardPos, SearchAlgorithm Algorithm>
 static void BM_MonkeyMoore_WildcardRelative(benchmark::State &state) {
    const size_t buffer_size_bytes = state.range(0);
    auto data = generate_data<DataType>(buffer_size_bytes);
@@ -55,6 +127,11 @@ static void BM_MonkeyMoore_WildcardRelative(benchmark::State &state) {
    }
 
    MonkeyMoore<DataType> searcher(keyword, '*', {});
+   searcher.set_algorithm(Algorithm);
+
+   if (Algorithm == SearchAlgorithm::Vectorized) {
+      state.SetLabel(mmoore::to_string(mmoore::resolve_instruction_set()));
+   }
 
    for (auto _ : state) {
       auto results = searcher.search(data.data(), data.size());
@@ -64,44 +141,1104 @@ static void BM_MonkeyMoore_WildcardRelative(benchmark::State &state) {
    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(data.size()) * sizeof(DataType));
 }
 
-BENCHMARK_TEMPLATE(BM_MonkeyMoore_Relative, uint8_t)
+// baseline for the multi-keyword search: one full scan per keyword
+template<typename DataType, bool Wildcards>
+static void BM_MonkeyMoore_MultiKeyword_Separate(benchmark::State &state) {
+   auto data = generate_data<DataType>(4 << 20);
+   auto keywords = generate_keywords(state.range(0), Wildcards);
+
+   std::vector<MonkeyMoore<DataType>> searchers;
+   searchers.reserve(keywords.size());
+
+   for (const auto &keyword : keywords) {
+      searchers.emplace_back(keyword, '*', std::vector<CharType>{});
+   }
+
+   for (auto _ : state) {
+      for (auto &searcher : searchers) {
+         auto results = searcher.search(data.data(), data.size());
+         benchmark::DoNotOptimize(results);
+      }
+   }
+
+   state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(data.size()) * sizeof(DataType));
+}
+
+// Automatic leaves the choice to MultiMonkeyMoore, which scans small keyword sets one keyword
+// at a time with the vectorized kernels. SinglePass forces the automaton (the scalar tier)
+template<typename DataType, bool Wildcards, bool SinglePass>
+static void BM_MonkeyMoore_MultiKeyword(benchmark::State &state) {
+   auto data = generate_data<DataType>(4 << 20);
+
+   MultiMonkeyMoore<DataType> searcher(generate_keywords(state.range(0), Wildcards), '*');
+
+   if (SinglePass) {
+      searcher.set_instruction_set(mmoore::InstructionSet::Scalar);
+   }
+
+   for (auto _ : state) {
+      auto results = searcher.search(data.data(), data.size());
+      benchmark::DoNotOptimize(results);
+   }
+
+   state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(data.size()) * sizeof(DataType));
+}
+
+// short interactive queries over text, indexed by keyword length
+template<typename DataType, SearchAlgorithm Algorithm>
+static void BM_MonkeyMoore_Text(benchmark::State &state) {
+   auto data = generate_text_data<DataType>(16 << 20);
+
+   const std::u32string words[] = { U"axe", U"item", U"sword", U"treasure", U"thunderbolts" };
+   const std::u32string &word = *std::find_if(std::begin(words), std::end(words), [&](const std::u32string &w) {
+      return static_cast<int64_t>(w.size()) == state.range(0);
+   });
+
+   MonkeyMoore<DataType> searcher(std::vector<CharType>(word.begin(), word.end()), 0, {});
+   searcher.set_algorithm(Algorithm);
+
+   for (auto _ : state) {
+      auto results = searcher.search(data.data(), data.size());
+      benchmark::DoNotOptimize(results);
+   }
+
+   state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(data.size()) * sizeof(DataType));
+}
+
+// short keyword over the default hiragana sequence, on data full of it, so the cost is
+// dominated by recording matches (which used to build a map of the whole sequence each).
+// Indexed by how they are recorded: 0 collects them in a vector, 1 only counts them
+static void BM_MonkeyMoore_FrequentMatches(benchmark::State &state) {
+   std::vector<CharType> hiragana;
+   for (CharType c = 0x3041; c <= 0x3093; ++c) {
+      hiragana.push_back(c);
+   }
+
+   const std::vector<CharType> keyword = { 0x3042, 0x3044, 0x3046 };
+
+   std::vector<uint16_t> data(4 << 20);
+   std::mt19937 rng(42);
+   std::uniform_int_distribution<int> symbol_dist(0, 3);
+
+   for (auto &v : data) {
+      v = static_cast<uint16_t>(0x3042 + 2 * symbol_dist(rng));
+   }
+
+   MonkeyMoore<uint16_t> searcher(keyword, 0, hiragana);
+   size_t matches = 0;
+
+   for (auto _ : state) {
+      if (state.range(0) == 0) {
+         auto results = searcher.search(data.data(), data.size());
+         matches = results.size();
+         benchmark::DoNotOptimize(results);
+      }
+      else {
+         MatchCounter counter;
+         searcher.search(data.data(), data.size(), counter);
+         matches = counter.count;
+      }
+   }
+
+   state.counters["matches"] = static_cast<double>(matches);
+   state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(data.size()) * sizeof(uint16_t));
+}
+
+// periodic keywords over repetitive data, where the bad-character shift collapses to 1
+template<typename DataType, int KeywordType>
+static void BM_MonkeyMoore_Periodic(benchmark::State &state) {
+   const size_t buffer_size_bytes = state.range(0);
+   auto data = generate_repetitive_data<DataType>(buffer_size_bytes);
+
+   std::vector<CharType> keyword;
+
+   if constexpr (KeywordType == 0) {
+      keyword = { 'a', 'a', 'a', 'b' };
+   }
+   else if constexpr (KeywordType == 1) {
+      keyword = { 'b', 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'a' };
+   }
+   else if constexpr (KeywordType == 2) {
+      keyword = { 'b', 'a', 'a', 'a', 'a', 'a', 'a', 'a', '*', 'a', 'a', 'a', 'a', 'a', 'a', 'a' };
+   }
+
+   MonkeyMoore<DataType> searcher(keyword, '*', {});
+   searcher.set_algorithm(SearchAlgorithm::BoyerMoore);
+
+   for (auto _ : state) {
+      auto results = searcher.search(data.data(), data.size());
+      benchmark::DoNotOptimize(results);
+   }
+
+   state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(data.size()) * sizeof(DataType));
+}
+
+template<typename DataType>
+static void BM_MonkeyMoore_InstructionSet(benchmark::State &state, mmoore::InstructionSet instruction_set) {
+   auto data = generate_data<DataType>(16 << 20);
+
+   std::vector<CharType> keyword = { 'a', 'b', '*', 'd', 'e' };
+   MonkeyMoore<DataType> searcher(keyword, '*', {});
+   searcher.set_algorithm(SearchAlgorithm::Vectorized);
+   searcher.set_instruction_set(instruction_set);
+
+   // reports the tier that actually ran, since requests are clamped to what the CPU supports
+   state.SetLabel(mmoore::to_string(mmoore::resolve_instruction_set(instruction_set)));
+
+   for (auto _ : state) {
+      auto results = searcher.search(data.data(), data.size());
+      benchmark::DoNotOptimize(results);
+   }
+
+   state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(data.size()) * sizeof(DataType));
+}
+
+// end-to-end engine run over a temporary file, indexed by the number of keywords, so both
+// pipelines (and byte orders) pay for the same reads and block bookkeeping
+template<typename DataType, mmoore::SearchPipeline Pipeline, mmoore::Endianness ByteOrder = mmoore::Endianness::Little>
+static void BM_SearchEngine_Pipeline(benchmark::State &state) {
+   auto data = generate_text_data<DataType>(32 << 20);
+   auto path = std::filesystem::temp_directory_path() / "mmoore_bench_pipeline.bin";
+
+   if (ByteOrder != mmoore::system_endianness) {
+      for (auto &value : data) {
+         value = mmoore::swap_always(value);
+      }
+   }
+
+   {
+      std::ofstream file(path, std::ios::binary);
+      file.write(reinterpret_cast<const char *>(data.data()), data.size() * sizeof(DataType));
+   }
+
+   mmoore::SearchConfig config;
+   config.file_path = path;
+   config.pipeline = Pipeline;
+   config.endianness = ByteOrder;
+
+   // a single worker over large blocks, so the rows compare the per-core scan rather than
+   // the scheduling of the blocks
+   config.preferred_num_threads = 1;
+   config.preferred_search_block_size = 8 << 20;
+
+   auto keywords = generate_keywords(state.range(0));
+
+   if (keywords.size() == 1) {
+      config.keyword = keywords[0];
+   }
+   else {
+      config.keywords = keywords;
+   }
+
+   std::atomic<bool> abort{false};
+
+   for (auto _ : state) {
+      mmoore::SearchEngine<DataType> engine(config);
+      auto results = engine.run([](int, const mmoore::SearchStep) {}, abort);
+      benchmark::DoNotOptimize(results);
+   }
+
+   state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(data.size()) * sizeof(DataType));
+   std::filesystem::remove(path);
+}
+
+// end-to-end engine run with the default threads, indexed by the number of keywords. The file
+// stays in the page cache, so the rows compare the cost of getting the blocks to the workers
+// (mapping vs. a read and a buffer per block)
+template<typename DataType, mmoore::FileAccess Access>
+static void BM_SearchEngine_FileAccess(benchmark::State &state) {
+   auto data = generate_text_data<DataType>(64 << 20);
+   auto path = std::filesystem::temp_directory_path() / "mmoore_bench_file_access.bin";
+
+   {
+      std::ofstream file(path, std::ios::binary);
+      file.write(reinterpret_cast<const char *>(data.data()), data.size() * sizeof(DataType));
+   }
+
+   mmoore::SearchConfig config;
+   config.file_path = path;
+   config.file_access = Access;
+
+   auto keywords = generate_keywords(state.range(0));
+
+   if (keywords.size() == 1) {
+      config.keyword = keywords[0];
+   }
+   else {
+      config.keywords = keywords;
+   }
+
+   std::atomic<bool> abort{false};
+   mmoore::SearchStats stats;
+
+   for (auto _ : state) {
+      mmoore::SearchEngine<DataType> engine(config);
+      auto results = engine.run([](int, const mmoore::SearchStep) {}, abort);
+      benchmark::DoNotOptimize(results);
+
+      stats = engine.stats();
+   }
+
+   state.counters["buffer_allocs"] = static_cast<double>(stats.buffer_allocations);
+   state.counters["peak_rss_mb"] = static_cast<double>(stats.peak_rss_bytes >> 20);
+
+   state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(data.size()) * sizeof(DataType));
+   std::filesystem::remove(path);
+}
+
+// evicts the file from the page cache where the OS allows it, so the next run reads it from disk
+static void drop_from_page_cache(const std::filesystem::path &path) {
+#if defined(__unix__)
+   int fd = ::open(path.c_str(), O_RDONLY);
+
+   if (fd >= 0) {
+      ::fdatasync(fd);
+      ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+      ::close(fd);
+   }
+#else
+   (void)path;
+#endif
+}
+
+// bytes of the file in the page cache (0 where it can't be queried)
+static uint64_t page_cache_resident_bytes(const std::filesystem::path &path) {
+   uint64_t resident = 0;
+
+#if defined(__unix__)
+   const size_t size = static_cast<size_t>(std::filesystem::file_size(path));
+   const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+   int fd = ::open(path.c_str(), O_RDONLY);
+
+   if (fd >= 0 && size > 0) {
+      void *mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+
+      if (mapping != MAP_FAILED) {
+         std::vector<unsigned char> pages((size + page - 1) / page);
+
+         if (::mincore(mapping, size, pages.data()) == 0) {
+            resident = std::count_if(pages.begin(), pages.end(), [](unsigned char p) { return p & 1; }) * page;
+         }
+
+         ::munmap(mapping, size);
+      }
+   }
+
+   if (fd >= 0) {
+      ::close(fd);
+   }
+#else
+   (void)path;
+#endif
+
+   return resident;
+}
+
+// one-shot scan of a file that isn't in the page cache, for each way of reading it. The
+// counter shows how much of the file the scan left behind in the cache
+template<typename DataType, mmoore::FileAccess Access>
+static void BM_SearchEngine_ColdScan(benchmark::State &state) {
+   auto data = generate_text_data<DataType>(64 << 20);
+   auto path = std::filesystem::temp_directory_path() / "mmoore_bench_cold_scan.bin";
+
+   {
+      std::ofstream file(path, std::ios::binary);
+      file.write(reinterpret_cast<const char *>(data.data()), data.size() * sizeof(DataType));
+   }
+
+   mmoore::SearchConfig config;
+   config.file_path = path;
+   config.keyword = generate_keywords(1)[0];
+   config.file_access = Access;
+
+   std::atomic<bool> abort{false};
+   uint64_t cached_bytes = 0;
+
+   for (auto _ : state) {
+      state.PauseTiming();
+      drop_from_page_cache(path);
+      state.ResumeTiming();
+
+      mmoore::SearchEngine<DataType> engine(config);
+      auto results = engine.run([](int, const mmoore::SearchStep) {}, abort);
+      benchmark::DoNotOptimize(results);
+
+      state.PauseTiming();
+      cached_bytes = page_cache_resident_bytes(path);
+      state.ResumeTiming();
+   }
+
+   state.counters["cached_mb"] = static_cast<double>(cached_bytes >> 20);
+
+   state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(data.size()) * sizeof(DataType));
+   std::filesystem::remove(path);
+}
+
+// end-to-end Stream run from a cold page cache with one worker, indexed by the read-ahead
+// depth (0 reads each block right before scanning it). The counters split the worker's time
+// between waiting for blocks and scanning them
+template<typename DataType, mmoore::ReadAheadBackend Backend>
+static void BM_SearchEngine_ReadAhead(benchmark::State &state) {
+   auto data = generate_text_data<DataType>(64 << 20);
+   auto path = std::filesystem::temp_directory_path() / "mmoore_bench_read_ahead.bin";
+
+   {
+      std::ofstream file(path, std::ios::binary);
+      file.write(reinterpret_cast<const char *>(data.data()), data.size() * sizeof(DataType));
+   }
+
+   mmoore::SearchConfig config;
+   config.file_path = path;
+   config.keyword = generate_keywords(1)[0];
+   config.file_access = mmoore::FileAccess::Stream;
+   config.preferred_num_threads = 1;
+   config.read_ahead_backend = Backend;
+   config.read_ahead_depth = static_cast<int>(state.range(0));
+
+   std::atomic<bool> abort{false};
+   mmoore::SearchStats stats;
+
+   for (auto _ : state) {
+      state.PauseTiming();
+      drop_from_page_cache(path);
+      state.ResumeTiming();
+
+      mmoore::SearchEngine<DataType> engine(config);
+      auto results = engine.run([](int, const mmoore::SearchStep) {}, abort);
+      benchmark::DoNotOptimize(results);
+
+      stats = engine.stats();
+   }
+
+   const auto io_wait = std::chrono::duration<double, std::milli>(stats.io_wait_time).count();
+   const auto compute = std::chrono::duration<double, std::milli>(stats.compute_time).count();
+
+   state.counters["io_wait_ms"] = io_wait;
+   state.counters["compute_ms"] = compute;
+   state.counters["io_wait_share"] = io_wait + compute > 0 ? io_wait / (io_wait + compute) : 0;
+
+   state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(data.size()) * sizeof(DataType));
+   std::filesystem::remove(path);
+}
+
+// end-to-end run over a sparse file of range(0) GB (holes read back as zeros, as they aren't
+// skipped), with a few keywords planted past the 4 GB mark. Measures how the engine holds up
+// on drive-sized images
+template<typename DataType, mmoore::FileAccess Access>
+static void BM_SearchEngine_SparseFile(benchmark::State &state) {
+   const uint64_t file_size = static_cast<uint64_t>(state.range(0)) << 30;
+   auto path = std::filesystem::temp_directory_path() / "mmoore_bench_sparse.bin";
+
+   auto keyword = generate_keywords(1)[0];
+
+   {
+      std::vector<DataType> planted(keyword.begin(), keyword.end());
+      std::ofstream file(path, std::ios::binary);
+
+      for (uint64_t offset = uint64_t(1) << 32; offset + 4096 < file_size; offset += uint64_t(1) << 28) {
+         file.seekp(static_cast<std::streamoff>(offset));
+         file.write(reinterpret_cast<const char *>(planted.data()), planted.size() * sizeof(DataType));
+      }
+   }
+
+   std::filesystem::resize_file(path, file_size);
+
+   mmoore::SearchConfig config;
+   config.file_path = path;
+   config.keyword = keyword;
+   config.file_access = Access;
+   config.skip_holes = false;
+
+   std::atomic<bool> abort{false};
+   size_t matches = 0;
+
+   for (auto _ : state) {
+      mmoore::SearchEngine<DataType> engine(config);
+      auto results = engine.run([](int, const mmoore::SearchStep) {}, abort);
+      matches = results.size();
+   }
+
+   state.counters["matches"] = static_cast<double>(matches);
+
+   state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(file_size));
+   std::filesystem::remove(path);
+}
+
+// end-to-end run over a 10%-dense sparse image of 2 GB: 1 MB of text every 10 MB, holes
+// in between. Compares skipping the holes to reading them back as zeros
+template<typename DataType, bool SkipHoles>
+static void BM_SearchEngine_SparseImage(benchmark::State &state) {
+   const uint64_t file_size = uint64_t(2) << 30;
+   const uint64_t extent_size = 1 << 20;
+   auto path = std::filesystem::temp_directory_path() / "mmoore_bench_sparse_image.bin";
+
+   {
+      auto extent = generate_text_data<DataType>(extent_size);
+      std::ofstream file(path, std::ios::binary);
+
+      for (uint64_t offset = 0; offset < file_size; offset += 10 * extent_size) {
+         file.seekp(static_cast<std::streamoff>(offset));
+         file.write(reinterpret_cast<const char *>(extent.data()), extent.size() * sizeof(DataType));
+      }
+   }
+
+   std::filesystem::resize_file(path, file_size);
+
+   mmoore::SearchConfig config;
+   config.file_path = path;
+   config.keyword = generate_keywords(1)[0];
+   config.skip_holes = SkipHoles;
+
+   std::atomic<bool> abort{false};
+   mmoore::SearchStats stats;
+
+   for (auto _ : state) {
+      mmoore::SearchEngine<DataType> engine(config);
+      auto results = engine.run([](int, const mmoore::SearchStep) {}, abort);
+      benchmark::DoNotOptimize(results);
+
+      stats = engine.stats();
+   }
+
+   state.counters["skipped_mb"] = static_cast<double>(stats.bytes_skipped >> 20);
+
+   state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(file_size));
+   std::filesystem::remove(path);
+}
+
+// end-to-end engine run with the default block size, indexed by the number of threads
+template<typename DataType>
+static void BM_SearchEngine_Threads(benchmark::State &state) {
+   auto data = generate_text_data<DataType>(64 << 20);
+   auto path = std::filesystem::temp_directory_path() / "mmoore_bench_threads.bin";
+
+   {
+      std::ofstream file(path, std::ios::binary);
+      file.write(reinterpret_cast<const char *>(data.data()), data.size() * sizeof(DataType));
+   }
+
+   mmoore::SearchConfig config;
+   config.file_path = path;
+   config.keyword = generate_keywords(1)[0];
+   config.preferred_num_threads = static_cast<int>(state.range(0));
+
+   std::atomic<bool> abort{false};
+
+   for (auto _ : state) {
+      mmoore::SearchEngine<DataType> engine(config);
+      auto results = engine.run([](int, const mmoore::SearchStep) {}, abort);
+      benchmark::DoNotOptimize(results);
+   }
+
+   state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(data.size()) * sizeof(DataType));
+   std::filesystem::remove(path);
+}
+
+// end-to-end engine run with the default threads, indexed by the block size in KB (0 lets the
+// engine pick one from the cache sizes)
+template<typename DataType>
+static void BM_SearchEngine_BlockSize(benchmark::State &state) {
+   auto data = generate_text_data<DataType>(64 << 20);
+   auto path = std::filesystem::temp_directory_path() / "mmoore_bench_block_size.bin";
+
+   {
+      std::ofstream file(path, std::ios::binary);
+      file.write(reinterpret_cast<const char *>(data.data()), data.size() * sizeof(DataType));
+   }
+
+   mmoore::SearchConfig config;
+   config.file_path = path;
+   config.keyword = generate_keywords(1)[0];
+   config.preferred_search_block_size = static_cast<uint64_t>(state.range(0)) << 10;
+
+   std::atomic<bool> abort{false};
+   mmoore::SearchStats stats;
+
+   for (auto _ : state) {
+      mmoore::SearchEngine<DataType> engine(config);
+      auto results = engine.run([](int, const mmoore::SearchStep) {}, abort);
+      benchmark::DoNotOptimize(results);
+
+      stats = engine.stats();
+   }
+
+   state.counters["block_kb"] = static_cast<double>(stats.block_size >> 10);
+   state.counters["threads"] = static_cast<double>(stats.num_threads);
+
+   state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(data.size()) * sizeof(DataType));
+   std::filesystem::remove(path);
+}
+
+// time-to-result of an engine run over a cartridge-sized file with the default settings,
+// indexed by the file size in KB. Inline runs small files on the calling thread, in one block
+template<typename DataType, bool Inline>
+static void BM_SearchEngine_SmallFile(benchmark::State &state) {
+   const size_t file_size = static_cast<size_t>(state.range(0)) << 10;
+   auto data = generate_text_data<DataType>(file_size);
+   auto path = std::filesystem::temp_directory_path() / "mmoore_bench_small_file.bin";
+
+   {
+      std::ofstream file(path, std::ios::binary);
+      file.write(reinterpret_cast<const char *>(data.data()), data.size() * sizeof(DataType));
+   }
+
+   mmoore::SearchConfig config;
+   config.file_path = path;
+   config.keyword = generate_keywords(1)[0];
+
+   if (!Inline) {
+      config.inline_search_size = 0;
+   }
+
+   std::atomic<bool> abort{false};
+   mmoore::SearchStats stats;
+
+   for (auto _ : state) {
+      mmoore::SearchEngine<DataType> engine(config);
+      auto results = engine.run([](int, const mmoore::SearchStep) {}, abort);
+      benchmark::DoNotOptimize(results);
+
+      stats = engine.stats();
+   }
+
+   state.counters["blocks"] = static_cast<double>(stats.num_blocks);
+   state.counters["threads"] = static_cast<double>(stats.num_threads);
+
+   state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(data.size()) * sizeof(DataType));
+   std::filesystem::remove(path);
+}
+
+// end-to-end engine run over 16 MB of data where a short keyword matches every few values,
+// indexed by what the run reports: 0 results with previews, 1 results, 2 the total count,
+// 3 the counts by encoding, 4 a result store (bytes_per_result is the memory held per match)
+template<typename DataType>
+static void BM_SearchEngine_Output(benchmark::State &state) {
+   std::vector<DataType> data((16 << 20) / sizeof(DataType));
+   std::mt19937 rng(42);
+   std::uniform_int_distribution<int> symbol_dist(0, 3);
+   std::uniform_int_distribution<int> encoding_dist(0, 7);
+
+   // runs of text in one of a few encodings
+   for (size_t i = 0; i < data.size(); i += 64) {
+      const int base = 0x20 + 0x10 * encoding_dist(rng);
+
+      for (size_t j = i; j < std::min(i + 64, data.size()); ++j) {
+         data[j] = static_cast<DataType>(base + 2 * symbol_dist(rng));
+      }
+   }
+
+   auto path = std::filesystem::temp_directory_path() / "mmoore_bench_output.bin";
+
+   {
+      std::ofstream file(path, std::ios::binary);
+      file.write(reinterpret_cast<const char *>(data.data()), data.size() * sizeof(DataType));
+   }
+
+   mmoore::SearchConfig config;
+   config.file_path = path;
+   config.keyword = { 'a', 'c', 'e' };
+
+   std::atomic<bool> abort{false};
+   uint64_t matches = 0;
+   uint64_t result_bytes = 0;
+
+   for (auto _ : state) {
+      mmoore::SearchEngine<DataType> engine(config);
+
+      switch (state.range(0)) {
+         case 0:
+         case 1: {
+            auto results = engine.run([](int, const mmoore::SearchStep) {}, abort, state.range(0) == 0);
+            benchmark::DoNotOptimize(results);
+
+            // the maps are shared, the previews outgrowing the string's inline buffer aren't
+            result_bytes = results.capacity() * sizeof(mmoore::SearchResult<DataType>);
+            for (const auto &result : results) {
+               result_bytes += result.preview.capacity() > 15 ? result.preview.capacity() + 1 : 0;
+            }
+            break;
+         }
+         case 2:
+            benchmark::DoNotOptimize(engine.count([](int, const mmoore::SearchStep) {}, abort));
+            break;
+         case 3: {
+            auto counts = engine.count_by_encoding([](int, const mmoore::SearchStep) {}, abort);
+            benchmark::DoNotOptimize(counts);
+            break;
+         }
+         default: {
+            auto store = engine.collect([](int, const mmoore::SearchStep) {}, abort);
+            benchmark::DoNotOptimize(store);
+
+            result_bytes = store.memory_usage();
+            break;
+         }
+      }
+
+      matches = engine.stats().matches;
+   }
+
+   state.counters["matches"] = static_cast<double>(matches);
+
+   if (matches > 0 && result_bytes > 0) {
+      state.counters["bytes_per_result"] = static_cast<double>(result_bytes) / static_cast<double>(matches);
+   }
+
+   state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(data.size()) * sizeof(DataType));
+   std::filesystem::remove(path);
+}
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_Relative, uint8_t, SearchAlgorithm::BoyerMoore)
    ->Name("BM_Search/Relative/8-Bit")
    ->RangeMultiplier(4)
    ->Range(128<<10, 16<<20);
 
-BENCHMARK_TEMPLATE(BM_MonkeyMoore_Relative, uint16_t)
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_Relative, uint16_t, SearchAlgorithm::BoyerMoore)
    ->Name("BM_Search/Relative/16-Bit")
    ->RangeMultiplier(4)
    ->Range(128<<10, 16<<20);
 
-BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint8_t, 0)
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_Relative, uint8_t, SearchAlgorithm::Vectorized)
+   ->Name("BM_Search/Relative/Vectorized/8-Bit")
+   ->RangeMultiplier(4)
+   ->Range(128<<10, 16<<20);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_Relative, uint16_t, SearchAlgorithm::Vectorized)
+   ->Name("BM_Search/Relative/Vectorized/16-Bit")
+   ->RangeMultiplier(4)
+   ->Range(128<<10, 16<<20);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint8_t, 0, SearchAlgorithm::BoyerMoore)
    ->Name("BM_Search/Relative/Wildcard/Front/8-Bit")
    ->RangeMultiplier(4)
    ->Range(128<<10, 16<<20);
 
-BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint8_t, 1)
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint8_t, 1, SearchAlgorithm::BoyerMoore)
    ->Name("BM_Search/Relative/Wildcard/Middle/8-Bit")
    ->RangeMultiplier(4)
    ->Range(128<<10, 16<<20);
 
-BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint8_t, 2)
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint8_t, 2, SearchAlgorithm::BoyerMoore)
    ->Name("BM_Search/Relative/Wildcard/Back/8-Bit")
    ->RangeMultiplier(4)
    ->Range(128<<10, 16<<20);
 
-BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint16_t, 0)
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint16_t, 0, SearchAlgorithm::BoyerMoore)
    ->Name("BM_Search/Relative/Wildcard/Front/16-Bit")
    ->RangeMultiplier(4)
    ->Range(128<<10, 16<<20);
 
-BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint16_t, 1)
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint16_t, 1, SearchAlgorithm::BoyerMoore)
    ->Name("BM_Search/Relative/Wildcard/Middle/16-Bit")
    ->RangeMultiplier(4)
    ->Range(128<<10, 16<<20);
 
-BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint16_t, 2)
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint16_t, 2, SearchAlgorithm::BoyerMoore)
    ->Name("BM_Search/Relative/Wildcard/Back/16-Bit")
    ->RangeMultiplier(4)
    ->Range(128<<10, 16<<20);
 
-BENCHMARK_MAIN();
\ No newline at end of file
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint8_t, 0, SearchAlgorithm::Vectorized)
+   ->Name("BM_Search/Relative/Wildcard/Vectorized/Front/8-Bit")
+   ->RangeMultiplier(4)
+   ->Range(128<<10, 16<<20);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint8_t, 1, SearchAlgorithm::Vectorized)
+   ->Name("BM_Search/Relative/Wildcard/Vectorized/Middle/8-Bit")
+   ->RangeMultiplier(4)
+   ->Range(128<<10, 16<<20);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint8_t, 2, SearchAlgorithm::Vectorized)
+   ->Name("BM_Search/Relative/Wildcard/Vectorized/Back/8-Bit")
+   ->RangeMultiplier(4)
+   ->Range(128<<10, 16<<20);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint16_t, 0, SearchAlgorithm::Vectorized)
+   ->Name("BM_Search/Relative/Wildcard/Vectorized/Front/16-Bit")
+   ->RangeMultiplier(4)
+   ->Range(128<<10, 16<<20);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint16_t, 1, SearchAlgorithm::Vectorized)
+   ->Name("BM_Search/Relative/Wildcard/Vectorized/Middle/16-Bit")
+   ->RangeMultiplier(4)
+   ->Range(128<<10, 16<<20);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint16_t, 2, SearchAlgorithm::Vectorized)
+   ->Name("BM_Search/Relative/Wildcard/Vectorized/Back/16-Bit")
+   ->RangeMultiplier(4)
+   ->Range(128<<10, 16<<20);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint8_t, 0, SearchAlgorithm::BitParallel)
+   ->Name("BM_Search/Relative/Wildcard/BitParallel/Front/8-Bit")
+   ->RangeMultiplier(4)
+   ->Range(128<<10, 16<<20);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint8_t, 1, SearchAlgorithm::BitParallel)
+   ->Name("BM_Search/Relative/Wildcard/BitParallel/Middle/8-Bit")
+   ->RangeMultiplier(4)
+   ->Range(128<<10, 16<<20);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint8_t, 2, SearchAlgorithm::BitParallel)
+   ->Name("BM_Search/Relative/Wildcard/BitParallel/Back/8-Bit")
+   ->RangeMultiplier(4)
+   ->Range(128<<10, 16<<20);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint16_t, 0, SearchAlgorithm::BitParallel)
+   ->Name("BM_Search/Relative/Wildcard/BitParallel/Front/16-Bit")
+   ->RangeMultiplier(4)
+   ->Range(128<<10, 16<<20);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint16_t, 1, SearchAlgorithm::BitParallel)
+   ->Name("BM_Search/Relative/Wildcard/BitParallel/Middle/16-Bit")
+   ->RangeMultiplier(4)
+   ->Range(128<<10, 16<<20);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_WildcardRelative, uint16_t, 2, SearchAlgorithm::BitParallel)
+   ->Name("BM_Search/Relative/Wildcard/BitParallel/Back/16-Bit")
+   ->RangeMultiplier(4)
+   ->Range(128<<10, 16<<20);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_Text, uint8_t, SearchAlgorithm::BoyerMoore)
+   ->Name("BM_Search/Relative/Text/BoyerMoore/8-Bit")
+   ->Arg(3)->Arg(4)->Arg(5)->Arg(8)->Arg(12);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_Text, uint8_t, SearchAlgorithm::QGram)
+   ->Name("BM_Search/Relative/Text/QGram/8-Bit")
+   ->Arg(3)->Arg(4)->Arg(5)->Arg(8)->Arg(12);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_Text, uint8_t, SearchAlgorithm::Vectorized)
+   ->Name("BM_Search/Relative/Text/Vectorized/8-Bit")
+   ->Arg(3)->Arg(4)->Arg(5)->Arg(8)->Arg(12);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_Text, uint16_t, SearchAlgorithm::BoyerMoore)
+   ->Name("BM_Search/Relative/Text/BoyerMoore/16-Bit")
+   ->Arg(3)->Arg(4)->Arg(5)->Arg(8)->Arg(12);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_Text, uint16_t, SearchAlgorithm::QGram)
+   ->Name("BM_Search/Relative/Text/QGram/16-Bit")
+   ->Arg(3)->Arg(4)->Arg(5)->Arg(8)->Arg(12);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_Text, uint16_t, SearchAlgorithm::Vectorized)
+   ->Name("BM_Search/Relative/Text/Vectorized/16-Bit")
+   ->Arg(3)->Arg(4)->Arg(5)->Arg(8)->Arg(12);
+
+BENCHMARK(BM_MonkeyMoore_FrequentMatches)
+   ->Name("BM_Search/Relative/FrequentMatches/16-Bit")
+   ->Arg(0)->Arg(1)
+   ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_Pipeline, uint8_t, mmoore::SearchPipeline::Direct)
+   ->Name("BM_Engine/Pipeline/Direct/8-Bit")
+   ->Arg(1)->Arg(8)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_Pipeline, uint8_t, mmoore::SearchPipeline::DeltaTransform)
+   ->Name("BM_Engine/Pipeline/DeltaTransform/8-Bit")
+   ->Arg(1)->Arg(8)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_Pipeline, uint16_t, mmoore::SearchPipeline::Direct)
+   ->Name("BM_Engine/Pipeline/Direct/16-Bit")
+   ->Arg(1)->Arg(8)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_Pipeline, uint16_t, mmoore::SearchPipeline::DeltaTransform)
+   ->Name("BM_Engine/Pipeline/DeltaTransform/16-Bit")
+   ->Arg(1)->Arg(8)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_Pipeline, uint16_t, mmoore::SearchPipeline::Direct, mmoore::Endianness::Big)
+   ->Name("BM_Engine/Pipeline/Direct/16-Bit/BigEndian")
+   ->Arg(1)->Arg(8)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_Threads, uint8_t)
+   ->Name("BM_Engine/Threads/8-Bit")
+   ->RangeMultiplier(2)->Range(1, 16)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_Threads, uint16_t)
+   ->Name("BM_Engine/Threads/16-Bit")
+   ->RangeMultiplier(2)->Range(1, 16)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_BlockSize, uint8_t)
+   ->Name("BM_Engine/BlockSize/8-Bit")
+   ->Arg(0)->Arg(64)->Arg(512)->Arg(8192)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_BlockSize, uint16_t)
+   ->Name("BM_Engine/BlockSize/16-Bit")
+   ->Arg(0)->Arg(64)->Arg(512)->Arg(8192)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_SmallFile, uint8_t, true)
+   ->Name("BM_Engine/SmallFile/Inline/8-Bit")
+   ->Arg(32)->Arg(256)->Arg(1024)
+   ->Unit(benchmark::kMicrosecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_SmallFile, uint8_t, false)
+   ->Name("BM_Engine/SmallFile/Pooled/8-Bit")
+   ->Arg(32)->Arg(256)->Arg(1024)
+   ->Unit(benchmark::kMicrosecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_SmallFile, uint16_t, true)
+   ->Name("BM_Engine/SmallFile/Inline/16-Bit")
+   ->Arg(32)->Arg(256)->Arg(1024)
+   ->Unit(benchmark::kMicrosecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_SmallFile, uint16_t, false)
+   ->Name("BM_Engine/SmallFile/Pooled/16-Bit")
+   ->Arg(32)->Arg(256)->Arg(1024)
+   ->Unit(benchmark::kMicrosecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_Output, uint8_t)
+   ->Name("BM_Engine/Output/8-Bit")
+   ->Arg(0)->Arg(1)->Arg(2)->Arg(3)->Arg(4)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_Output, uint16_t)
+   ->Name("BM_Engine/Output/16-Bit")
+   ->Arg(0)->Arg(1)->Arg(2)->Arg(3)->Arg(4)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_FileAccess, uint8_t, mmoore::FileAccess::MemoryMapped)
+   ->Name("BM_Engine/FileAccess/MemoryMapped/8-Bit")
+   ->Arg(1)->Arg(8)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_FileAccess, uint8_t, mmoore::FileAccess::Stream)
+   ->Name("BM_Engine/FileAccess/Stream/8-Bit")
+   ->Arg(1)->Arg(8)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_FileAccess, uint16_t, mmoore::FileAccess::MemoryMapped)
+   ->Name("BM_Engine/FileAccess/MemoryMapped/16-Bit")
+   ->Arg(1)->Arg(8)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_FileAccess, uint16_t, mmoore::FileAccess::Stream)
+   ->Name("BM_Engine/FileAccess/Stream/16-Bit")
+   ->Arg(1)->Arg(8)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_ReadAhead, uint8_t, mmoore::ReadAheadBackend::IoUring)
+   ->Name("BM_Engine/ReadAhead/IoUring/8-Bit")
+   ->Arg(0)->Arg(1)->Arg(2)->Arg(4)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_ReadAhead, uint8_t, mmoore::ReadAheadBackend::Thread)
+   ->Name("BM_Engine/ReadAhead/Thread/8-Bit")
+   ->Arg(0)->Arg(1)->Arg(2)->Arg(4)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_ReadAhead, uint16_t, mmoore::ReadAheadBackend::IoUring)
+   ->Name("BM_Engine/ReadAhead/IoUring/16-Bit")
+   ->Arg(0)->Arg(1)->Arg(2)->Arg(4)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_ReadAhead, uint16_t, mmoore::ReadAheadBackend::Thread)
+   ->Name("BM_Engine/ReadAhead/Thread/16-Bit")
+   ->Arg(0)->Arg(1)->Arg(2)->Arg(4)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_ColdScan, uint8_t, mmoore::FileAccess::MemoryMapped)
+   ->Name("BM_Engine/ColdScan/MemoryMapped/8-Bit")
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_ColdScan, uint8_t, mmoore::FileAccess::Stream)
+   ->Name("BM_Engine/ColdScan/Stream/8-Bit")
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_ColdScan, uint8_t, mmoore::FileAccess::Direct)
+   ->Name("BM_Engine/ColdScan/Direct/8-Bit")
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_ColdScan, uint16_t, mmoore::FileAccess::MemoryMapped)
+   ->Name("BM_Engine/ColdScan/MemoryMapped/16-Bit")
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_ColdScan, uint16_t, mmoore::FileAccess::Stream)
+   ->Name("BM_Engine/ColdScan/Stream/16-Bit")
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_ColdScan, uint16_t, mmoore::FileAccess::Direct)
+   ->Name("BM_Engine/ColdScan/Direct/16-Bit")
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_SparseFile, uint8_t, mmoore::FileAccess::MemoryMapped)
+   ->Name("BM_Engine/SparseFile/MemoryMapped/8-Bit")
+   ->Arg(6)
+   ->Iterations(2)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_SparseFile, uint8_t, mmoore::FileAccess::Stream)
+   ->Name("BM_Engine/SparseFile/Stream/8-Bit")
+   ->Arg(6)
+   ->Iterations(2)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_SparseFile, uint16_t, mmoore::FileAccess::MemoryMapped)
+   ->Name("BM_Engine/SparseFile/MemoryMapped/16-Bit")
+   ->Arg(6)
+   ->Iterations(2)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_SparseFile, uint16_t, mmoore::FileAccess::Stream)
+   ->Name("BM_Engine/SparseFile/Stream/16-Bit")
+   ->Arg(6)
+   ->Iterations(2)
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_SparseImage, uint8_t, false)
+   ->Name("BM_Engine/SparseImage/ReadHoles/8-Bit")
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_SparseImage, uint8_t, true)
+   ->Name("BM_Engine/SparseImage/SkipHoles/8-Bit")
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_SparseImage, uint16_t, false)
+   ->Name("BM_Engine/SparseImage/ReadHoles/16-Bit")
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchEngine_SparseImage, uint16_t, true)
+   ->Name("BM_Engine/SparseImage/SkipHoles/16-Bit")
+   ->Unit(benchmark::kMillisecond)
+   ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_Periodic, uint8_t, 0)
+   ->Name("BM_Search/Relative/Periodic/Short/8-Bit")
+   ->Arg(16<<20);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_Periodic, uint8_t, 1)
+   ->Name("BM_Search/Relative/Periodic/Run/8-Bit")
+   ->Arg(16<<20);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_Periodic, uint8_t, 2)
+   ->Name("BM_Search/Relative/Periodic/Wildcard/8-Bit")
+   ->Arg(16<<20);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_Periodic, uint16_t, 0)
+   ->Name("BM_Search/Relative/Periodic/Short/16-Bit")
+   ->Arg(16<<20);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_Periodic, uint16_t, 1)
+   ->Name("BM_Search/Relative/Periodic/Run/16-Bit")
+   ->Arg(16<<20);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_Periodic, uint16_t, 2)
+   ->Name("BM_Search/Relative/Periodic/Wildcard/16-Bit")
+   ->Arg(16<<20);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_MultiKeyword_Separate, uint8_t, false)
+   ->Name("BM_Search/MultiKeyword/Separate/8-Bit")
+   ->Arg(20)->Arg(200);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_MultiKeyword_Separate, uint16_t, false)
+   ->Name("BM_Search/MultiKeyword/Separate/16-Bit")
+   ->Arg(20)->Arg(200);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_MultiKeyword, uint8_t, false, false)
+   ->Name("BM_Search/MultiKeyword/Automatic/8-Bit")
+   ->Arg(20)->Arg(200);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_MultiKeyword, uint16_t, false, false)
+   ->Name("BM_Search/MultiKeyword/Automatic/16-Bit")
+   ->Arg(20)->Arg(200);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_MultiKeyword, uint8_t, false, true)
+   ->Name("BM_Search/MultiKeyword/SinglePass/8-Bit")
+   ->Arg(20)->Arg(200);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_MultiKeyword, uint16_t, false, true)
+   ->Name("BM_Search/MultiKeyword/SinglePass/16-Bit")
+   ->Arg(20)->Arg(200);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_MultiKeyword_Separate, uint8_t, true)
+   ->Name("BM_Search/MultiKeyword/Wildcard/Separate/8-Bit")
+   ->Arg(20)->Arg(200);
+
+BENCHMARK_TEMPLATE(BM_MonkeyMoore_MultiKeyword, uint8_t, true, true)
+   ->Name("BM_Search/MultiKeyword/Wildcard/SinglePass/8-Bit")
+   ->Arg(20)->Arg(200);
+
+int main(int argc, char **argv) {
+   benchmark::Initialize(&argc, argv);
+
+   if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+      return 1;
+   }
+
+   const auto detected = mmoore::detect_instruction_set();
+
+   benchmark::AddCustomContext("mmoore_detected_isa", mmoore::to_string(detected));
+   benchmark::AddCustomContext("mmoore_active_isa", mmoore::to_string(mmoore::resolve_instruction_set()));
+
+   // one row per tier supported by this machine, so they can be compared side by side
+   const mmoore::InstructionSet tiers[] = {
+      mmoore::InstructionSet::SSE2,
+      mmoore::InstructionSet::SSE42,
+      mmoore::InstructionSet::AVX2,
+      mmoore::InstructionSet::AVX512
+   };
+
+   for (auto tier : tiers) {
+      if (static_cast<int>(tier) > static_cast<int>(detected)) {
+         continue;
+      }
+
+      std::string tier_name = mmoore::to_string(tier);
+
+      benchmark::RegisterBenchmark(
+         ("BM_Search/Relative/ISA/" + tier_name + "/8-Bit").c_str(), 
+         BM_MonkeyMoore_InstructionSet<uint8_t>, 
+         tier);
+
+      benchmark::RegisterBenchmark(
+         ("BM_Search/Relative/ISA/" + tier_name + "/16-Bit").c_str(), 
+         BM_MonkeyMoore_InstructionSet<uint16_t>, 
+         tier);
+   }
+
+   benchmark::RunSpecifiedBenchmarks();
+   benchmark::Shutdown();
+
+   return 0;
+}
\ No newline at end of file
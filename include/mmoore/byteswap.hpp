@@ -4,6 +4,7 @@
 #define MONKEY_CORE_BYTESWAP_HPP
 
 #include <cstdint>
+#include <cstring>
 #include <algorithm>
 
 namespace mmoore {
@@ -13,9 +14,22 @@ namespace mmoore {
       Big
    };
 
-   inline Endianness get_system_endianness() {
-      const int value = 1;
-      return reinterpret_cast<const char *>(&value)[0] ? Endianness::Little : Endianness::Big;
+   /**
+    * Byte order of the target platform, known at compile time.
+    */
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+   constexpr Endianness system_endianness = Endianness::Big;
+#else
+   constexpr Endianness system_endianness = Endianness::Little;
+#endif
+
+   // the other byte order, whose values need swapping before use
+   constexpr Endianness foreign_endianness = system_endianness == Endianness::Little 
+      ? Endianness::Big 
+      : Endianness::Little;
+
+   constexpr Endianness get_system_endianness() {
+      return system_endianness;
    }
 
    template <typename T>
@@ -42,7 +56,7 @@ namespace mmoore {
     */
    template <typename T>
    T swap_on_little_endian(T value) {
-      if (get_system_endianness() == Endianness::Little) {
+      if constexpr (system_endianness == Endianness::Little) {
          return swap_always(value);
       }
 
@@ -54,7 +68,7 @@ namespace mmoore {
     */
    template <typename T>
    T swap_on_big_endian(T value) {
-      if (get_system_endianness() == Endianness::Big) {
+      if constexpr (system_endianness == Endianness::Big) {
          return swap_always(value);
       }
 
@@ -69,14 +83,30 @@ namespace mmoore {
     */
    template<typename T>
    void adjust_endianness(T *dataPtr, size_t count, Endianness desired_endianness) {
-      Endianness system_endianness = get_system_endianness();
-
       if (system_endianness != desired_endianness) {
          std::transform(dataPtr, dataPtr + count, dataPtr, [](T value) {
             return swap_always<T>(value);
          });
       }
    }
+
+   /**
+    * Loads a value stored in the given byte order and returns it in the system's byte order.
+    * Kernels take the order as a template parameter, so native loads compile to plain reads.
+    * The source needn't be aligned, blocks are scanned in place at any byte offset.
+    */
+   template <Endianness Order, typename T>
+   inline T load_ordered(const T *source) {
+      T value;
+      std::memcpy(&value, source, sizeof(T));
+
+      if constexpr (Order == system_endianness) {
+         return value;
+      }
+      else {
+         return swap_always<T>(value);
+      }
+   }
 } // namespace mmoore
 
 #endif // MONKEY_CORE_BYTESWAP_HPP
\ No newline at end of file
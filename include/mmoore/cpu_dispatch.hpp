@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef MONKEY_CORE_CPU_DISPATCH_HPP
+#define MONKEY_CORE_CPU_DISPATCH_HPP
+
+#include <string>
+
+namespace mmoore {
+
+   /**
+    * Instruction set tiers the search kernels are compiled for, from the least to
+    * the most capable. Automatic resolves to the best tier supported by the CPU.
+    */
+   enum class InstructionSet {
+      Automatic,
+      Scalar,     // portable C++, no SIMD kernels
+      SSE2,       // baseline x86-64
+      SSE42,
+      AVX2,
+      AVX512      // AVX-512 F + BW
+   };
+
+   /**
+    * Name of the environment variable that forces a specific tier when
+    * the caller doesn't request one (e.g. MMOORE_INSTRUCTION_SET=sse2).
+    */
+   constexpr const char *instruction_set_env_var = "MMOORE_INSTRUCTION_SET";
+
+   /**
+    * Queries cpuid (once) for the best tier supported by the current CPU and OS.
+    */
+   InstructionSet detect_instruction_set();
+
+   /**
+    * Resolves the tier the kernels will run with. An explicit request takes precedence
+    * over the environment variable, and both are clamped to what the CPU supports.
+    * @param requested desired tier, or Automatic
+    */
+   InstructionSet resolve_instruction_set(InstructionSet requested = InstructionSet::Automatic);
+
+   /**
+    * Parses a tier name (scalar, sse2, sse4.2, avx2, avx512), case insensitive.
+    * @return The tier, or Automatic if the name isn't recognized
+    */
+   InstructionSet parse_instruction_set(const std::string &name);
+
+   const char *to_string(InstructionSet instruction_set);
+}
+
+#endif // MONKEY_CORE_CPU_DISPATCH_HPP
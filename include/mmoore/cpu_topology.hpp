@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef MONKEY_CORE_CPU_TOPOLOGY_HPP
+#define MONKEY_CORE_CPU_TOPOLOGY_HPP
+
+#include <cstddef>
+
+namespace mmoore {
+
+   /**
+    * Core counts and cache sizes of the machine, used to size the search blocks and pick
+    * the number of workers. Cache sizes that can't be queried are 0.
+    */
+   struct CpuTopology {
+      unsigned physical_cores = 1;
+      unsigned logical_cores = 1;
+
+      // per core
+      size_t l2_cache_size = 0;
+
+      // shared by the cores of a package
+      size_t l3_cache_size = 0;
+   };
+
+   /**
+    * Queries the OS (once) for the topology of the current machine.
+    */
+   const CpuTopology &detect_cpu_topology();
+}
+
+#endif // MONKEY_CORE_CPU_TOPOLOGY_HPP
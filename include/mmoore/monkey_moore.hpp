@@ -7,18 +7,114 @@
 #include <map>
 #include <string>
 #include <utility>
+#include <type_traits>
 #include <algorithm>
 #include <vector>
 #include <limits>
 #include <cassert>
 #include <cstdint>
 
+#include "mmoore/cpu_dispatch.hpp"
+#include "mmoore/byteswap.hpp"
+
 using CharType = char32_t;
 
+/**
+ * Strategy used by MonkeyMoore to scan the data buffer.
+ */
+enum class SearchAlgorithm {
+   Automatic,     // picks the fastest strategy available for the keyword
+   BoyerMoore,    // scalar relative Boyer-Moore
+   Vectorized,    // SIMD candidate filter followed by scalar verification
+   QGram,         // Wu-Manber style shifts indexed by pairs of consecutive differences
+   BitParallel    // BNDM automaton over the differences, wildcards cost nothing (up to 65 characters)
+};
+
+/**
+ * Encoding implied by a match, which its equivalency map is built from on request (see
+ * MonkeyMoore::make_equivalency_map). Matches with the same encoding share the same map,
+ * so it can be used to tell them apart without building any.
+ */
+template <class Ty> struct MatchEncoding {
+   // value of 'a', or of the character at index 0 of the custom character sequence
+   Ty base = 0;
+
+   // value of 'A' (unused with custom character sequences)
+   Ty upper_base = 0;
+
+   // both values packed into one integer, for hashing
+   uint32_t key() const {
+      return static_cast<uint32_t>(base) | static_cast<uint32_t>(upper_base) << 16;
+   }
+
+   friend bool operator==(const MatchEncoding &a, const MatchEncoding &b) {
+      return a.base == b.base && a.upper_base == b.upper_base;
+   }
+
+   friend bool operator!=(const MatchEncoding &a, const MatchEncoding &b) {
+      return !(a == b);
+   }
+};
+
+/**
+ * Non-owning reference to the callable that receives the matches of a search as they are
+ * found, so nothing is collected in between. The kernels stay out of line and call it
+ * through a pointer; the callable must outlive the search.
+ */
+template <class Match> class MatchSink {
+public:
+   template <
+      class Fn, 
+      class = std::enable_if_t<!std::is_same_v<std::decay_t<Fn>, MatchSink>>
+   >
+   MatchSink(Fn &&fn) 
+      : target(const_cast<void *>(static_cast<const void *>(std::addressof(fn)))), 
+        emit(&invoke<std::remove_reference_t<Fn>>) {}
+
+   void operator()(const Match &match) const { 
+      emit(target, match); 
+   }
+
+private:
+   void *target;
+   void (*emit)(void *, const Match &);
+
+   template <class Fn> 
+   static void invoke(void *target, const Match &match) {
+      (*static_cast<Fn *>(target))(match);
+   }
+};
+
+/**
+ * Sink that only counts the matches.
+ */
+struct MatchCounter {
+   uint64_t count = 0;
+
+   template <class Match> 
+   void operator()(const Match &) { ++count; }
+};
+
+template <class Ty> class MultiMonkeyMoore;
+
 template <class Ty> class MonkeyMoore {
 public:
    using equivalency_map = std::map<CharType, Ty>;
-   using result_type = std::pair<uint64_t, equivalency_map>;
+   using encoding_type = MatchEncoding<Ty>;
+
+   // matches are plain values, so finding one allocates nothing
+   struct result_type {
+      uint64_t offset;
+      encoding_type encoding;
+
+      friend bool operator==(const result_type &a, const result_type &b) {
+         return a.offset == b.offset && a.encoding == b.encoding;
+      }
+
+      friend bool operator!=(const result_type &a, const result_type &b) {
+         return !(a == b);
+      }
+   };
 
    /**
     * Standard relative search constructor.
@@ -50,12 +146,116 @@ public:
    */
    std::vector <result_type> search(const Ty *data, uint64_t data_len);
 
+   using sink_type = MatchSink<result_type>;
+
+   /**
+   * Same search, handing each match to sink as soon as it's found (in increasing offset
+   * order) instead of collecting them.
+   * @param data pointer to binary data to be searched
+   * @param data_len length of data
+   * @param sink callable taking a const result_type &, e.g. a lambda or a MatchCounter
+   */
+   void search(const Ty *data, uint64_t data_len, sink_type sink);
+
+   /**
+   * Performs the same search over a precomputed difference stream, so one stream can be
+   * shared by several searchers. The longest run of differences between adjacent literals
+   * is located with memchr/memcmp, and each hit is verified against the data.
+   * @param data pointer to binary data to be searched
+   * @param deltas difference stream of data (see compute_delta_stream)
+   * @param data_len length of data
+   * @return Search results
+   */
+   std::vector <result_type> search_delta_stream(const Ty *data, const uint8_t *deltas, uint64_t data_len);
+
+   /**
+   * Same search over the difference stream, handing each match to sink (see search).
+   */
+   void search_delta_stream(const Ty *data, const uint8_t *deltas, uint64_t data_len, sink_type sink);
+
+   /**
+   * Converts data to its packed difference stream, where deltas[i] holds the low byte of
+   * data[i + 1] - data[i]. 16-bit differences are truncated, which only lets through more
+   * candidates, as every candidate is verified against the data.
+   * @param data pointer to binary data
+   * @param data_len length of data
+   * @param deltas receives the data_len - 1 differences
+   * @param byte_order byte order of the values in data
+   */
+   static void compute_delta_stream(
+      const Ty *data, 
+      uint64_t data_len, 
+      std::vector<uint8_t> &deltas,
+      mmoore::Endianness byte_order = mmoore::system_endianness
+   );
+
+   /**
+   * Builds the equivalency map of a match: the values of 'a' and 'A', or of every
+   * character of the custom character sequence (empty for value scans).
+   * @param encoding encoding of a match found by this searcher
+   */
+   equivalency_map make_equivalency_map(const encoding_type &encoding) const;
+
+   /**
+   * Overrides the strategy used to scan the data. Strategies that don't
+   * support the current keyword fall back to the scalar Boyer-Moore search.
+   * @param algorithm desired search strategy
+   */
+   void set_algorithm(SearchAlgorithm algorithm);
+
+   /**
+   * Forces the instruction set tier of the vectorized kernels. The request is
+   * clamped to what the CPU supports (see mmoore::resolve_instruction_set).
+   * @param instruction_set desired tier, or Automatic to use the best one available
+   */
+   void set_instruction_set(mmoore::InstructionSet instruction_set);
+
+   /**
+   * Sets the byte order of the searched values. Every kernel is compiled for both orders
+   * and swaps foreign-order values as it loads them, so the data is searched in place.
+   * Results (offsets and encodings) are the same as searching swapped data.
+   * @param byte_order byte order of the data, the system's by default (ignored for 8-bit data)
+   */
+   void set_byte_order(mmoore::Endianness byte_order);
+
 private:
+   // reuses the keyword tables to verify and decode the automaton hits
+   friend class MultiMonkeyMoore<Ty>;
+
    enum { none, simple_relative, wildcard_relative, value_scan } search_mode;
+   SearchAlgorithm algorithm = SearchAlgorithm::Automatic;
+   mmoore::InstructionSet instruction_set = mmoore::InstructionSet::Automatic;
+   mmoore::Endianness byte_order = mmoore::system_endianness;
    
    std::vector<CharType> keyword;
    std::vector<int> expected_diff;
-   std::vector<int> skip_table;
+
+   // bad-character shifts, saturated to 255 and indexed by the low bits of the signed difference
+   // (see skip_table_index). Differences sharing an entry keep the smallest shift, which keeps
+   // the table at 512 bytes for 16-bit data instead of one entry per possible difference.
+   static constexpr int skip_table_bits = 9;
+   std::vector<uint8_t> skip_table;
+   std::vector<int> good_suffix_table;
+
+   // Wu-Manber shift table, indexed by the low bytes of the last two differences of the window,
+   // empty when the keyword is too short to use it
+   static constexpr int qgram_table_bits = 16;
+   int qgram_rematch_shift = 1;
+   std::vector<uint8_t> qgram_shift_table;
+
+   // BNDM masks over the adjacent differences of the keyword, indexed by bit_parallel_class of the
+   // difference (bit m-1-p is set when pattern position p accepts it), empty for longer keywords
+   static constexpr long bit_parallel_max_symbols = 64;
+   std::vector<uint8_t> bit_parallel_class;
+   std::vector<uint64_t> bit_parallel_masks;
+
+   // longest run of differences between adjacent literals, starting at keyword position
+   // delta_anchor_start, searched for in the difference stream (empty when there's none)
+   long delta_anchor_start = 0;
+   std::vector<uint8_t> delta_anchor;
+
+   // position of the anchor difference located first with memchr
+   size_t delta_anchor_key = 0;
 
    const CharType wildcard;
    std::vector<CharType> case_normalized_keyword;
@@ -65,9 +265,10 @@ private:
    std::vector<Ty> wc_expected_diff;
    std::vector<Ty> wc_bitmask;
 
-   bool has_case_change;
-   bool mostly_lowercase;
-   int wildcards_count;
+   bool has_case_change = false;
+   bool mostly_lowercase = false;
+   int wildcards_count = 0;
+   int leading_wildcards_count = 0;
 
    std::vector<CharType> custom_character_seq;
    std::map<CharType, int> custom_character_index;
@@ -80,9 +281,44 @@ private:
    void preprocess();
    void preprocess_no_wildcards();
    void preprocess_with_wildcards();
+   void preprocess_good_suffix(const std::vector<int> &compared_offset);
+   void preprocess_qgrams();
+   void preprocess_bit_parallel();
+   void preprocess_delta_anchor();
+
+   // kernels and helpers below are instantiated for the byte order of the data they read,
+   // see set_byte_order
+   template <mmoore::Endianness Order> 
+   void search_in_order(const Ty *data, uint64_t data_len, sink_type sink);
+   template <mmoore::Endianness Order> 
+   void search_delta_stream_in_order(const Ty *data, const uint8_t *deltas, uint64_t data_len, sink_type sink);
+
+   template <mmoore::Endianness Order> 
+   void monkey_moore(const Ty *data, uint64_t data_len, sink_type sink);
+   template <mmoore::Endianness Order> 
+   void monkey_moore_wc(const Ty *data, uint64_t data_len, sink_type sink);
+   template <mmoore::Endianness Order> 
+   void monkey_moore_simd(const Ty *data, uint64_t data_len, sink_type sink);
+   template <mmoore::Endianness Order> 
+   void monkey_moore_wc_simd(const Ty *data, uint64_t data_len, sink_type sink);
+   template <mmoore::Endianness Order> 
+   void monkey_moore_qgram(const Ty *data, uint64_t data_len, sink_type sink);
+   template <mmoore::Endianness Order> 
+   void monkey_moore_bndm(const Ty *data, uint64_t data_len, sink_type sink);
+
+   static size_t skip_table_index(int diff) {
+      return static_cast<size_t>(diff + std::numeric_limits<Ty>::max()) & ((size_t(1) << skip_table_bits) - 1);
+   }
+
+   // whether the data is in the foreign byte order (8-bit values read the same in both)
+   bool reads_swapped_data() const {
+      return sizeof(Ty) > 1 && byte_order != mmoore::system_endianness;
+   }
 
-   std::vector <result_type> monkey_moore(const Ty *data, uint64_t data_len);
-   std::vector <result_type> monkey_moore_wc(const Ty *data, uint64_t data_len);
+   template <mmoore::Endianness Order> bool is_simple_match(const Ty *window) const;
+   template <mmoore::Endianness Order> bool is_wildcard_match(const Ty *window) const;
+   template <mmoore::Endianness Order> encoding_type make_simple_encoding(const Ty *window);
+   template <mmoore::Endianness Order> encoding_type make_wildcard_encoding(const Ty *window);
 
    std::vector<int> compute_relative_values(
       const std::vector<CharType> &source
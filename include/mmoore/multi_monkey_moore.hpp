@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef MONKEY_CORE_MULTI_MONKEY_MOORE_HPP
+#define MONKEY_CORE_MULTI_MONKEY_MOORE_HPP
+
+#include <vector>
+#include <cstdint>
+
+#include "mmoore/monkey_moore.hpp"
+
+/**
+ * Relative search for many keywords in a single pass over the data.
+ * Keywords are compiled into an Aho-Corasick automaton over the alphabet of relative
+ * differences, so the scan cost doesn't grow with the number of keywords. Keywords with
+ * wildcards or case changes are compiled as their longest run of adjacent literals, which
+ * anchors the rest of the keyword. Each hit is verified against the whole keyword with the
+ * same rules as MonkeyMoore, so the results for every keyword are identical to an
+ * individual search.
+ *
+ * Some keywords are still scanned one by one over the same buffer: those without two
+ * adjacent literals (e.g. "a*b*c"), which have nothing to anchor, and sets of up to
+ * vectorized_keyword_limit keywords when SIMD kernels are available, as a vectorized scan
+ * per keyword is faster than the automaton for them. The Scalar instruction set always
+ * uses the automaton.
+ */
+template <class Ty> class MultiMonkeyMoore {
+public:
+   using equivalency_map = typename MonkeyMoore<Ty>::equivalency_map;
+   using encoding_type = typename MonkeyMoore<Ty>::encoding_type;
+
+   struct result_type {
+      uint64_t offset;
+      uint32_t keyword_id;
+      encoding_type encoding;
+   };
+
+   /**
+    * @param keywords search keywords, identified by their index in this list
+    * @param wildcard character representing a wildcard
+    * @param char_seq user defined character sequence
+    */
+   MultiMonkeyMoore(
+      const std::vector<std::vector<CharType>> &keywords,
+      CharType wildcard = 0,
+      const std::vector<CharType> &char_seq = {}
+   );
+
+   /**
+    * Searches all keywords at once.
+    * @param data pointer to binary data to be searched
+    * @param data_len length of data
+    * @return Search results, ordered by offset and keyword id
+    */
+   std::vector<result_type> search(const Ty *data, uint64_t data_len);
+
+   using sink_type = MatchSink<result_type>;
+
+   /**
+    * Same search, handing each match to sink as soon as it's found. Matches of different
+    * keywords aren't ordered by offset.
+    * @param sink callable taking a const result_type &, e.g. a lambda or a MatchCounter
+    */
+   void search(const Ty *data, uint64_t data_len, sink_type sink);
+
+   /**
+    * Builds the equivalency map of a match (see MonkeyMoore::make_equivalency_map).
+    */
+   equivalency_map make_equivalency_map(const encoding_type &encoding) const;
+
+   void set_instruction_set(mmoore::InstructionSet instruction_set);
+
+   /**
+    * Sets the byte order of the searched values (see MonkeyMoore::set_byte_order).
+    */
+   void set_byte_order(mmoore::Endianness byte_order);
+
+private:
+   /**
+    * Below this many keywords, a vectorized scan per keyword is faster than walking
+    * the automaton (which runs at the same speed regardless of the keyword count).
+    */
+   static constexpr size_t vectorized_keyword_limit = 24;
+
+   std::vector<MonkeyMoore<Ty>> searchers;
+   mmoore::InstructionSet instruction_set = mmoore::InstructionSet::Automatic;
+   mmoore::Endianness byte_order = mmoore::system_endianness;
+
+   // keywords compiled into the automaton
+   std::vector<uint32_t> automaton_keywords;
+
+   // keywords without two adjacent literals can't be expressed as a sequence of
+   // differences, so they are searched individually over the same buffer
+   std::vector<uint32_t> fallback_keywords;
+
+   // per keyword, the positions of the first and last literals of the run compiled into the
+   // automaton (the whole keyword when it has no wildcards), so a hit ending at i is a
+   // window starting at i - anchor_end
+   std::vector<long> anchor_start;
+   std::vector<long> anchor_end;
+
+   // maps a wrapping relative difference to its index in the automaton's alphabet,
+   // differences that don't appear in any keyword share index 0
+   std::vector<uint32_t> symbol_class;
+   uint32_t alphabet_size = 1;
+
+   // deterministic automaton, indexed by row + symbol, where each entry holds the row
+   // offset (state * alphabet_size) of the next state
+   std::vector<uint32_t> transitions;
+
+   // states with outputs are numbered last, so every row from here on is accepting
+   uint32_t first_output_row = 0;
+
+   // keywords ending at the n-th accepting state are output_ids[output_begin[n] .. output_begin[n + 1])
+   std::vector<uint32_t> output_begin;
+   std::vector<uint32_t> output_ids;
+
+   void build_automaton();
+
+   template <mmoore::Endianness Order>
+   void search_automaton(const Ty *data, uint64_t data_len, sink_type sink);
+
+   void search_individually(
+      const std::vector<uint32_t> &keyword_ids,
+      const Ty *data,
+      uint64_t data_len,
+      sink_type sink
+   );
+};
+
+#endif // MONKEY_CORE_MULTI_MONKEY_MOORE_HPP
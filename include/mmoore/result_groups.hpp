@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef MONKEY_CORE_RESULT_GROUPS_HPP
+#define MONKEY_CORE_RESULT_GROUPS_HPP
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "mmoore/monkey_moore.hpp"
+#include "mmoore/result_store.hpp"
+#include "mmoore/search_engine.hpp"
+
+namespace mmoore {
+
+   /**
+    * Results sharing an encoding (see group_by_encoding).
+    */
+   template<typename DataType>
+   struct ResultGroup {
+      std::shared_ptr<const typename MonkeyMoore<DataType>::equivalency_map> values_map;
+
+      uint64_t count = 0;
+
+      // the group's first result, and its index in the grouped results
+      uint64_t first_offset = 0;
+      size_t first_index = 0;
+
+      // offsets of every result of the group, in the order of the grouped results
+      std::vector<uint64_t> offsets;
+   };
+
+   /**
+    * Groups the results of a run by their encoding in a single pass, hashing the equivalency
+    * maps the engine shares between the results of an encoding (results from different runs
+    * never share a group).
+    * @return one group per encoding, in order of first appearance
+    */
+   template<typename DataType>
+   std::vector<ResultGroup<DataType>> group_by_encoding(const std::vector<SearchResult<DataType>> &results);
+
+   /**
+    * Groups the results of a store by their encoding id.
+    * @return one group per encoding, indexed by encoding id
+    */
+   template<typename DataType>
+   std::vector<ResultGroup<DataType>> group_by_encoding(const ResultStore<DataType> &store);
+}
+
+#endif // MONKEY_CORE_RESULT_GROUPS_HPP
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef MONKEY_CORE_RESULT_STORE_HPP
+#define MONKEY_CORE_RESULT_STORE_HPP
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+#include "mmoore/monkey_moore.hpp"
+
+namespace mmoore {
+
+   template<typename DataType> class SearchEngine;
+
+   /**
+    * Compact storage for the results of a search, filled by SearchEngine::collect. Results are
+    * kept in columns sorted by offset: an offset and an encoding id per match (plus a keyword
+    * id for multi-keyword searches), the ids indexing a table of the distinct encodings and
+    * their equivalency maps. Previews aren't stored, they are read from the file on request.
+    */
+   template<typename DataType>
+   class ResultStore {
+   public:
+      using equivalency_map = typename MonkeyMoore<DataType>::equivalency_map;
+      using encoding_type = typename MonkeyMoore<DataType>::encoding_type;
+
+      size_t size() const { return offset_column.size(); }
+      bool empty() const { return offset_column.empty(); }
+
+      uint64_t offset(size_t index) const { return offset_column[index]; }
+
+      // index of the matched keyword in SearchConfig::keywords (0 for single keyword searches)
+      uint32_t keyword_id(size_t index) const {
+         return keyword_id_column.empty() ? 0 : keyword_id_column[index];
+      }
+
+      // index of the result's encoding in encodings(), in order of first appearance
+      uint32_t encoding_id(size_t index) const { return encoding_id_column[index]; }
+
+      const encoding_type &encoding(size_t index) const {
+         return encoding_table[encoding_id_column[index]];
+      }
+
+      // shared by every result with the same encoding (empty for value scans)
+      const equivalency_map &values_map(size_t index) const {
+         return *map_table[encoding_id_column[index]];
+      }
+
+      /**
+       * Reads the preview of a result from the file (see SearchConfig::preferred_preview_width).
+       * Not thread safe, as the reads share the store's file handle.
+       */
+      std::string preview(size_t index) const {
+         return preview_source
+            ? preview_source(offset_column[index], keyword_id(index), values_map(index))
+            : std::string();
+      }
+
+      const std::vector<uint64_t> &offsets() const { return offset_column; }
+      const std::vector<uint32_t> &encoding_ids() const { return encoding_id_column; }
+
+      // distinct encodings, and their maps, indexed by encoding id
+      size_t num_encodings() const { return encoding_table.size(); }
+      const std::vector<encoding_type> &encodings() const { return encoding_table; }
+
+      const std::shared_ptr<const equivalency_map> &equivalency_map_of(uint32_t encoding_id) const {
+         return map_table[encoding_id];
+      }
+
+      /**
+       * Bytes held by the store: its columns and the encoding table with its maps.
+       */
+      size_t memory_usage() const {
+         // std::map nodes hold the value next to three pointers and the color
+         constexpr size_t map_node_size = sizeof(typename equivalency_map::value_type) + 4 * sizeof(void *);
+
+         size_t bytes = sizeof(*this)
+            + offset_column.capacity() * sizeof(uint64_t)
+            + encoding_id_column.capacity() * sizeof(uint32_t)
+            + keyword_id_column.capacity() * sizeof(uint32_t)
+            + encoding_table.capacity() * sizeof(encoding_type)
+            + map_table.capacity() * sizeof(std::shared_ptr<const equivalency_map>);
+
+         for (const auto &values_map : map_table) {
+            bytes += sizeof(equivalency_map) + values_map->size() * map_node_size;
+         }
+
+         return bytes;
+      }
+
+   private:
+      friend class SearchEngine<DataType>;
+
+      std::vector<uint64_t> offset_column;
+      std::vector<uint32_t> encoding_id_column;
+
+      // empty for single keyword searches
+      std::vector<uint32_t> keyword_id_column;
+
+      std::vector<encoding_type> encoding_table;
+      std::vector<std::shared_ptr<const equivalency_map>> map_table;
+
+      // reads the preview of the result at an offset (set by the engine)
+      std::function<std::string(uint64_t, uint32_t, const equivalency_map &)> preview_source;
+   };
+}
+
+#endif // MONKEY_CORE_RESULT_STORE_HPP
@@ -5,19 +5,68 @@
 
 #include <filesystem>
 #include <vector>
+#include <memory>
 #include <atomic>
 #include <functional>
 #include <thread>
+#include <chrono>
 #include "mmoore/byteswap.hpp"
 #include "mmoore/monkey_moore.hpp"
+#include "mmoore/multi_monkey_moore.hpp"
+#include "mmoore/result_store.hpp"
 
 namespace mmoore {
 
+   class MappedFile;
+   struct FileExtent;
+
    template<typename DataType> 
    struct SearchResult {
       uint64_t offset;
-      typename MonkeyMoore<DataType>::equivalency_map values_map;
+
+      // shared by every result with the same encoding (empty for value scans)
+      std::shared_ptr<const typename MonkeyMoore<DataType>::equivalency_map> values_map;
       std::string preview;
+
+      // index of the matched keyword in SearchConfig::keywords (0 for single keyword searches)
+      uint32_t keyword_id = 0;
+   };
+
+   /**
+    * Number of matches sharing an encoding (see SearchEngine::count_by_encoding).
+    */
+   template<typename DataType> 
+   struct EncodingCount {
+      MatchEncoding<DataType> encoding;
+      std::shared_ptr<const typename MonkeyMoore<DataType>::equivalency_map> values_map;
+      uint64_t count;
+   };
+
+   /**
+    * How the workers scan each block.
+    */
+   enum class SearchPipeline {
+      Direct,           // each keyword is searched over the block's values
+      DeltaTransform    // the block is converted to a difference stream once, shared by every keyword
+   };
+
+   /**
+    * How the workers read the file.
+    */
+   enum class FileAccess {
+      MemoryMapped,     // blocks are scanned straight out of a read-only mapping (falls back to Stream)
+      Stream,           // each block is read into its own buffer
+      Direct            // like Stream, around the page cache, for one-shot scans of huge images
+   };
+
+   /**
+    * How Stream workers read their upcoming blocks while they scan the current one.
+    */
+   enum class ReadAheadBackend {
+      Automatic,        // io_uring where the kernel supports it, a reader thread otherwise
+      IoUring,          // a ring per worker (Linux only, falls back to Thread)
+      Thread,           // a reader thread per worker issuing positioned reads
+      None              // blocks are read synchronously, right before they are scanned
    };
 
    struct SearchConfig {
@@ -27,14 +76,84 @@ namespace mmoore {
       mmoore::Endianness endianness = Endianness::Little;
 
       std::vector<CharType> keyword;
+
+      // when not empty, relative searches look for all of these keywords in a single
+      // pass over the file and `keyword` is ignored
+      std::vector<std::vector<CharType>> keywords = {};
+
       std::vector<CharType> custom_char_seq = {};
       CharType wildcard = '*';
 
       std::vector<short> reference_values = {};
       
-      int preferred_num_threads = std::thread::hardware_concurrency();
-      int preferred_search_block_size = 524288;
+      // 0 picks the number of physical cores (a single one for small files)
+      int preferred_num_threads = 0;
+
+      // 0 picks a size from the L2/L3 cache sizes, shrunk for smaller files so every worker
+      // gets several blocks
+      uint64_t preferred_search_block_size = 0;
+
+      // files with up to this many bytes of data are searched in a single block, on the
+      // calling thread, unless the settings above say otherwise (0 disables it)
+      uint64_t inline_search_size = 1 << 20;
+
       int preferred_preview_width = 50;
+
+      // forces the tier of the vectorized kernels (benchmarking and bug triage)
+      mmoore::InstructionSet instruction_set = InstructionSet::Automatic;
+
+      SearchPipeline pipeline = SearchPipeline::Direct;
+
+      FileAccess file_access = FileAccess::MemoryMapped;
+
+      // backs the stream read buffers with huge pages where the OS supports it
+      bool huge_page_buffers = false;
+
+      // blocks each Stream worker keeps reading ahead of the one it scans (0 disables read-ahead)
+      int read_ahead_depth = 2;
+      ReadAheadBackend read_ahead_backend = ReadAheadBackend::Automatic;
+
+      // only scans the data of sparse files (and the keyword-sized windows around it), where the
+      // file system reports holes. Matches lying entirely inside a hole, which only keywords of
+      // repeated values have, aren't reported
+      bool skip_holes = true;
+   };
+
+   /**
+    * Resource usage of the last SearchEngine::run.
+    */
+   struct SearchStats {
+      // read buffers allocated by the workers (read_ahead_depth + 1 per worker at most, allocated
+      // by their first blocks)
+      uint64_t buffer_allocations = 0;
+      uint64_t buffer_bytes_allocated = 0;
+
+      // peak resident set size of the process at the end of the search (0 if unavailable)
+      uint64_t peak_rss_bytes = 0;
+
+      // time the workers spent waiting for their blocks and scanning them, summed over the
+      // workers (page faults on a mapping count as scanning)
+      std::chrono::nanoseconds io_wait_time{0};
+      std::chrono::nanoseconds compute_time{0};
+
+      // how the blocks were read ahead (None for mappings and synchronous reads)
+      ReadAheadBackend read_ahead_backend = ReadAheadBackend::None;
+
+      // whether Direct reads bypassed the page cache with direct I/O (where it isn't supported,
+      // the pages the reads brought into the cache are evicted once read instead)
+      bool direct_io = false;
+
+      // bytes of holes that weren't scanned (see SearchConfig::skip_holes)
+      uint64_t bytes_skipped = 0;
+
+      // how the file was split, and over how many workers (the automatic picks when the
+      // config leaves them to the engine)
+      uint64_t block_size = 0;
+      uint64_t num_blocks = 0;
+      size_t num_threads = 0;
+
+      // matches found, whichever way they were reported
+      uint64_t matches = 0;
    };
 
    enum SearchStep {
@@ -57,25 +176,106 @@ namespace mmoore {
          bool generate_previews = false
       );
 
+      /**
+       * Counts the matches without collecting them, so no results or previews are built.
+       * @return number of matches (0 when aborted)
+       */
+      uint64_t count(ProgressCallback on_progress, std::atomic<bool> &abort_flag);
+
+      /**
+       * Counts the matches of each encoding without collecting them, e.g. to check which
+       * encodings a file uses.
+       * @return one entry per encoding found, most frequent first (empty when aborted)
+       */
+      std::vector<EncodingCount<DataType>> count_by_encoding(
+         ProgressCallback on_progress, 
+         std::atomic<bool> &abort_flag
+      );
+
+      /**
+       * Collects the matches into a columnar store, a few bytes per match rather than a
+       * SearchResult each, for searches with millions of them. Previews are read from the
+       * file when asked for.
+       * @return the matches sorted by offset (empty when aborted)
+       */
+      ResultStore<DataType> collect(ProgressCallback on_progress, std::atomic<bool> &abort_flag);
+
+      const SearchStats &stats() const { return run_stats; }
+
    private:
       SearchConfig config;
+      SearchStats run_stats;
+
+      // what a search reports, see run, count, count_by_encoding and collect
+      enum class Output {
+         Results,
+         Count,
+         EncodingCounts,
+         Store
+      };
+
+      std::vector<EncodingCount<DataType>> encoding_counts;
+      ResultStore<DataType> result_store;
+
+      std::vector<SearchResult<DataType>> search(
+         ProgressCallback on_progress, 
+         std::atomic<bool> &abort_flag, 
+         bool generate_previews,
+         Output output
+      );
 
       struct SearchBlock {
          uint64_t offset;
-         uint32_t size;
+         uint64_t size;
+      };
+
+      // what the workers collect, the maps of the results are built once per encoding
+      struct Match {
+         uint64_t offset;
+         typename MonkeyMoore<DataType>::encoding_type encoding;
+         uint32_t keyword_id;
       };
 
-      std::vector<SearchBlock> compute_search_blocks(uint64_t file_size);
+      // tiles the data extents (and the windows around them) with overlapping blocks
+      std::vector<SearchBlock> compute_search_blocks(
+         uint64_t file_size, 
+         const std::vector<FileExtent> &data_extents
+      );
+
+      // automatic block sizes stay within these bounds, and leave each worker this many blocks
+      static constexpr uint64_t default_auto_block_size = 512 << 10;
+      static constexpr uint64_t min_auto_block_size = 4 << 10;
+      static constexpr uint64_t max_auto_block_size = 8 << 20;
+      static constexpr uint64_t blocks_per_worker = 4;
+
+      // distance between the starts of consecutive blocks (the block size without the overlap)
+      // and the number of workers of the current run, see tune
+      uint64_t block_size = 0;
+      size_t num_threads = 1;
+
+      /**
+       * Resolves the block size and the number of workers of a run over data_bytes bytes
+       * of data, picking the ones the config leaves at 0.
+       */
+      void tune(uint64_t data_bytes);
+
+      // length of the longest keyword (or value sequence), in values
+      size_t longest_pattern_length() const;
+
+      bool is_multi_keyword_search() const;
 
+      // reads from the mapping when there is one (not nullptr), from the stream otherwise
       std::string generate_preview(
+         const MappedFile *mapped_file,
          std::ifstream &file,
          uint64_t file_size,
          uint64_t match_offset, 
-         std::map<CharType, DataType> &values_map
+         size_t keyword_len,
+         const std::map<CharType, DataType> &values_map
       );
 
       std::string decode_raw_data(
-         std::map<CharType, DataType> &values_map,
+         const std::map<CharType, DataType> &values_map,
          std::vector<DataType> &raw_data
       );
    };
@@ -0,0 +1,305 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "block_io.hpp"
+#include "memory_utils.hpp"
+
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+   #include <cerrno>
+   #include <fcntl.h>
+   #include <sys/mman.h>
+   #include <sys/stat.h>
+   #include <unistd.h>
+#endif
+
+namespace {
+   constexpr size_t page_size = 4096;
+   constexpr size_t huge_page_size = 2 << 20;
+}
+
+mmoore::AlignedBuffer::~AlignedBuffer() {
+   release();
+}
+
+bool mmoore::AlignedBuffer::reserve(size_t size, bool huge_pages) {
+   if (size <= buffer_capacity) {
+      return false;
+   }
+
+   release();
+
+   // huge pages are only worth it (and only granted) for buffers spanning whole huge pages
+   const bool use_huge_pages = huge_pages && size >= huge_page_size;
+   const size_t alignment = use_huge_pages ? huge_page_size : page_size;
+   const size_t capacity = use_huge_pages ? align_up<huge_page_size>(size) : align_up<page_size>(size);
+
+   buffer = static_cast<uint8_t *>(::operator new(capacity, std::align_val_t(alignment)));
+   buffer_capacity = capacity;
+   buffer_alignment = alignment;
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+   if (use_huge_pages) {
+      ::madvise(buffer, capacity, MADV_HUGEPAGE);
+   }
+#endif
+
+   return true;
+}
+
+void mmoore::AlignedBuffer::release() {
+   if (buffer != nullptr) {
+      ::operator delete(buffer, std::align_val_t(buffer_alignment));
+      buffer = nullptr;
+      buffer_capacity = 0;
+   }
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+namespace {
+   // alignment required by direct reads of fd, 0 when it can't be met with page aligned buffers
+   size_t direct_io_alignment([[maybe_unused]] int fd) {
+      size_t alignment = 0;
+
+#if defined(STATX_DIOALIGN)
+      struct statx file_statx;
+
+      if (::statx(fd, "", AT_EMPTY_PATH, STATX_DIOALIGN, &file_statx) == 0 
+         && (file_statx.stx_mask & STATX_DIOALIGN) != 0) {
+         // the file system reports 0 when it doesn't support direct I/O on this file
+         if (file_statx.stx_dio_mem_align == 0 || file_statx.stx_dio_offset_align == 0) {
+            return 0;
+         }
+
+         alignment = std::max<size_t>(file_statx.stx_dio_mem_align, file_statx.stx_dio_offset_align);
+      }
+#endif
+
+      // older kernels: the file system block size is a multiple of the logical block size
+      struct stat file_stat;
+
+      if (alignment == 0 && ::fstat(fd, &file_stat) == 0 && file_stat.st_blksize > 0) {
+         alignment = static_cast<size_t>(file_stat.st_blksize);
+      }
+
+      const bool is_power_of_two = (alignment & (alignment - 1)) == 0;
+
+      return alignment <= page_size && is_power_of_two ? alignment : 0;
+   }
+}
+
+mmoore::FileReader::FileReader(const std::filesystem::path &path, bool bypass_cache) {
+#if defined(O_DIRECT)
+   if (bypass_cache) {
+      fd = ::open(path.c_str(), O_RDONLY | O_DIRECT);
+
+      if (fd >= 0) {
+         read_alignment = direct_io_alignment(fd);
+
+         if (read_alignment == 0) {
+            ::close(fd);
+            fd = -1;
+            read_alignment = 1;
+         }
+      }
+   }
+#endif
+
+   if (fd < 0) {
+      fd = ::open(path.c_str(), O_RDONLY);
+   }
+
+   if (fd < 0) {
+      throw std::runtime_error("Worker thread failed to open file: " + path.string());
+   }
+
+   if (bypass_cache && read_alignment == 1) {
+#if defined(__APPLE__)
+      ::fcntl(fd, F_NOCACHE, 1);
+#else
+      drop_behind = true;
+      system_page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+#endif
+   }
+}
+
+mmoore::FileReader::~FileReader() {
+   ::close(fd);
+}
+
+size_t mmoore::FileReader::read_at(uint64_t offset, uint8_t *target, size_t length) {
+   size_t total = 0;
+
+   while (total < length) {
+      ssize_t count = ::pread(fd, target + total, length - total, static_cast<off_t>(offset + total));
+
+      if (count < 0 && errno == EINTR) {
+         continue;
+      }
+
+      // a failed read would silently cut the block short and drop its matches
+      if (count < 0) {
+         throw std::system_error(errno, std::generic_category(), "Failed to read the file");
+      }
+
+      if (count == 0) {
+         break;
+      }
+
+      total += static_cast<size_t>(count);
+   }
+
+   return total;
+}
+
+void mmoore::FileReader::find_cached(uint64_t offset, size_t length, std::vector<uint8_t> &resident) {
+   resident.clear();
+
+   if (!drop_behind || length == 0) {
+      return;
+   }
+
+   // mapping the range costs no I/O, mincore only reports which of its pages are cached
+   const uint64_t map_start = offset - offset % system_page_size;
+   const size_t map_length = static_cast<size_t>(offset + length - map_start);
+
+   void *mapping = ::mmap(nullptr, map_length, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(map_start));
+
+   if (mapping == MAP_FAILED) {
+      return;
+   }
+
+   resident.resize((map_length + system_page_size - 1) / system_page_size);
+
+#if defined(__linux__)
+   unsigned char *residency = resident.data();
+#else
+   char *residency = reinterpret_cast<char *>(resident.data());
+#endif
+
+   if (::mincore(mapping, map_length, residency) != 0) {
+      resident.clear();
+   }
+
+   ::munmap(mapping, map_length);
+}
+
+void mmoore::FileReader::drop_cached(uint64_t offset, size_t length, const std::vector<uint8_t> &resident) {
+#if defined(POSIX_FADV_DONTNEED)
+   if (!drop_behind || length == 0 || resident.empty()) {
+      return;
+   }
+
+   const uint64_t map_start = offset - offset % system_page_size;
+   const size_t num_pages = std::min(resident.size(), (offset + length - map_start + system_page_size - 1) / system_page_size);
+
+   // evicts each run of pages the read brought into the cache
+   for (size_t page = 0; page < num_pages; ) {
+      if ((resident[page] & 1) != 0) {
+         ++page;
+         continue;
+      }
+
+      const size_t run_start = page;
+
+      while (page < num_pages && (resident[page] & 1) == 0) {
+         ++page;
+      }
+
+      ::posix_fadvise(
+         fd, 
+         static_cast<off_t>(map_start + run_start * system_page_size), 
+         static_cast<off_t>((page - run_start) * system_page_size), 
+         POSIX_FADV_DONTNEED);
+   }
+#endif
+}
+
+#else
+
+mmoore::FileReader::FileReader(const std::filesystem::path &path, bool) 
+   : stream(path, std::ios::binary) {
+   if (!stream.is_open()) {
+      throw std::runtime_error("Worker thread failed to open file: " + path.string());
+   }
+}
+
+mmoore::FileReader::~FileReader() = default;
+
+size_t mmoore::FileReader::read_at(uint64_t offset, uint8_t *target, size_t length) {
+   stream.clear();
+   stream.seekg(static_cast<std::streamoff>(offset));
+   stream.read(reinterpret_cast<char *>(target), static_cast<std::streamsize>(length));
+
+   if (stream.bad()) {
+      throw std::system_error(std::make_error_code(std::errc::io_error), "Failed to read the file");
+   }
+
+   return static_cast<size_t>(stream.gcount());
+}
+
+void mmoore::FileReader::find_cached(uint64_t, size_t, std::vector<uint8_t> &resident) {
+   resident.clear();
+}
+
+void mmoore::FileReader::drop_cached(uint64_t, size_t, const std::vector<uint8_t> &) {}
+
+#endif
+
+std::vector<mmoore::FileExtent> mmoore::find_data_extents(
+   [[maybe_unused]] const std::filesystem::path &path, 
+   uint64_t file_size
+) {
+   const std::vector<FileExtent> whole_file = { { 0, file_size } };
+
+   if (file_size == 0) {
+      return {};
+   }
+
+#if (defined(__unix__) || defined(__APPLE__)) && defined(SEEK_DATA) && defined(SEEK_HOLE)
+   const int fd = ::open(path.c_str(), O_RDONLY);
+
+   if (fd < 0) {
+      return whole_file;
+   }
+
+   std::vector<FileExtent> extents;
+   off_t position = 0;
+
+   while (static_cast<uint64_t>(position) < file_size) {
+      const off_t data_start = ::lseek(fd, position, SEEK_DATA);
+
+      if (data_start < 0) {
+         // ENXIO: nothing but a hole up to the end of the file. Anything else means holes
+         // can't be queried here, so the whole file is scanned
+         const bool reached_end = errno == ENXIO;
+         ::close(fd);
+
+         return reached_end ? extents : whole_file;
+      }
+
+      if (static_cast<uint64_t>(data_start) >= file_size) {
+         break;
+      }
+
+      off_t data_end = ::lseek(fd, data_start, SEEK_HOLE);
+
+      if (data_end <= data_start || static_cast<uint64_t>(data_end) > file_size) {
+         data_end = static_cast<off_t>(file_size);
+      }
+
+      extents.push_back({ static_cast<uint64_t>(data_start), static_cast<uint64_t>(data_end - data_start) });
+      position = data_end;
+   }
+
+   ::close(fd);
+
+   return extents;
+#else
+   return whole_file;
+#endif
+}
@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef MONKEY_CORE_BLOCK_IO_HPP
+#define MONKEY_CORE_BLOCK_IO_HPP
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace mmoore {
+
+   /**
+    * Grow-only, page aligned buffer reused by a worker for every block it reads, so
+    * the steady state of a search doesn't allocate.
+    */
+   class AlignedBuffer {
+   public:
+      AlignedBuffer() = default;
+      ~AlignedBuffer();
+
+      AlignedBuffer(const AlignedBuffer &) = delete;
+      AlignedBuffer &operator=(const AlignedBuffer &) = delete;
+
+      /**
+       * Makes room for at least size bytes. Reallocates only when size is larger than every
+       * previous request, discarding the contents.
+       * @param huge_pages asks the OS to back the buffer with huge pages (where supported)
+       * @return Whether a new buffer was allocated
+       */
+      bool reserve(size_t size, bool huge_pages = false);
+
+      uint8_t *data() { return buffer; }
+      size_t capacity() const { return buffer_capacity; }
+
+   private:
+      uint8_t *buffer = nullptr;
+      size_t buffer_capacity = 0;
+      size_t buffer_alignment = 0;
+
+      void release();
+   };
+
+   /**
+    * File handle owned by a single worker and kept open across blocks. Reads are positioned
+    * (pread where available), so they don't depend on a shared file offset.
+    */
+   class FileReader {
+   public:
+      /**
+       * @param bypass_cache reads around the page cache (direct I/O) where the file system
+       *        supports it, otherwise drop_cached evicts what the reads brought in
+       * @throws std::runtime_error if the file can't be opened
+       */
+      explicit FileReader(const std::filesystem::path &path, bool bypass_cache = false);
+      ~FileReader();
+
+      FileReader(const FileReader &) = delete;
+      FileReader &operator=(const FileReader &) = delete;
+
+      /**
+       * Reads up to length bytes starting at offset.
+       * @return Number of bytes read, short only at the end of the file
+       * @throws std::system_error if the read fails
+       */
+      size_t read_at(uint64_t offset, uint8_t *target, size_t length);
+
+      /**
+       * Granularity of direct reads: their offset, length and target address must be multiples
+       * of it. 1 when the reads go through the page cache.
+       */
+      size_t alignment() const { return read_alignment; }
+
+      /**
+       * Records which pages of a range are in the page cache before it is read, when the cache
+       * should have been bypassed but direct I/O wasn't available (no-op otherwise).
+       * @param resident one entry per page, left empty when residency can't be queried
+       */
+      void find_cached(uint64_t offset, size_t length, std::vector<uint8_t> &resident);
+
+      /**
+       * Evicts the pages of a range that has been read which weren't cached before it was
+       * (see find_cached), so the scan leaves the page cache as it found it. Nothing is
+       * evicted when their residency is unknown.
+       */
+      void drop_cached(uint64_t offset, size_t length, const std::vector<uint8_t> &resident);
+
+#if defined(__unix__) || defined(__APPLE__)
+      // descriptor for submitting reads through other interfaces (see ReadAheadQueue)
+      int native_handle() const { return fd; }
+#endif
+
+   private:
+#if defined(__unix__) || defined(__APPLE__)
+      int fd = -1;
+#else
+      std::ifstream stream;
+#endif
+
+      size_t read_alignment = 1;
+      bool drop_behind = false;
+
+      // granularity of the page cache, for find_cached and drop_cached
+      size_t system_page_size = 4096;
+   };
+
+   struct FileExtent {
+      uint64_t offset;
+      uint64_t length;
+   };
+
+   /**
+    * Ranges of the first file_size bytes of the file that hold data, in file order. Holes
+    * (unallocated ranges of sparse files, which read back as zeros) are left out where the
+    * file system reports them (SEEK_DATA/SEEK_HOLE), otherwise the whole file is one extent.
+    */
+   std::vector<FileExtent> find_data_extents(const std::filesystem::path &path, uint64_t file_size);
+}
+
+#endif // MONKEY_CORE_BLOCK_IO_HPP
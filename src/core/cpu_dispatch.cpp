@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "debug_logging.hpp"
+#include "mmoore/cpu_dispatch.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstdint>
+
+#if defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_IX86))
+   #include <intrin.h>
+   #include <immintrin.h>
+#endif
+
+namespace {
+
+   mmoore::InstructionSet query_cpu() {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+      // libgcc also checks XCR0, so AVX tiers are only reported when the OS saves their state
+      __builtin_cpu_init();
+
+      if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+         return mmoore::InstructionSet::AVX512;
+      }
+
+      if (__builtin_cpu_supports("avx2")) {
+         return mmoore::InstructionSet::AVX2;
+      }
+
+      if (__builtin_cpu_supports("sse4.2")) {
+         return mmoore::InstructionSet::SSE42;
+      }
+
+      if (__builtin_cpu_supports("sse2")) {
+         return mmoore::InstructionSet::SSE2;
+      }
+
+      return mmoore::InstructionSet::Scalar;
+
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+      int info[4] = {};
+
+      __cpuid(info, 0);
+      const int max_leaf = info[0];
+
+      __cpuid(info, 1);
+      const bool has_sse2 = (info[3] & (1 << 26)) != 0;
+      const bool has_sse42 = (info[2] & (1 << 20)) != 0;
+      const bool has_osxsave = (info[2] & (1 << 27)) != 0;
+
+      bool has_avx2 = false;
+      bool has_avx512 = false;
+
+      if (has_osxsave && max_leaf >= 7) {
+         const uint64_t xcr0 = _xgetbv(0);
+         const bool os_saves_ymm = (xcr0 & 0x06) == 0x06;
+         const bool os_saves_zmm = (xcr0 & 0xE6) == 0xE6;
+
+         __cpuidex(info, 7, 0);
+         has_avx2 = os_saves_ymm && (info[1] & (1 << 5)) != 0;
+         has_avx512 = os_saves_zmm && (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0;
+      }
+
+      if (has_avx512) return mmoore::InstructionSet::AVX512;
+      if (has_avx2) return mmoore::InstructionSet::AVX2;
+      if (has_sse42) return mmoore::InstructionSet::SSE42;
+      if (has_sse2) return mmoore::InstructionSet::SSE2;
+
+      return mmoore::InstructionSet::Scalar;
+
+#else
+      return mmoore::InstructionSet::Scalar;
+#endif
+   }
+
+   mmoore::InstructionSet read_env_override() {
+      const char *value = std::getenv(mmoore::instruction_set_env_var);
+
+      if (value == nullptr) {
+         return mmoore::InstructionSet::Automatic;
+      }
+
+      auto instruction_set = mmoore::parse_instruction_set(value);
+      MMOORE_LOG(mmoore::instruction_set_env_var, " = ", value, " -> ", mmoore::to_string(instruction_set));
+
+      return instruction_set;
+   }
+}
+
+mmoore::InstructionSet mmoore::detect_instruction_set() {
+   static const InstructionSet detected = query_cpu();
+   return detected;
+}
+
+mmoore::InstructionSet mmoore::resolve_instruction_set(InstructionSet requested) {
+   static const InstructionSet env_override = read_env_override();
+
+   if (requested == InstructionSet::Automatic) {
+      requested = env_override;
+   }
+
+   const InstructionSet supported = detect_instruction_set();
+
+   if (requested == InstructionSet::Automatic) {
+      return supported;
+   }
+
+   // never run a tier the CPU can't execute
+   return static_cast<int>(requested) < static_cast<int>(supported) ? requested : supported;
+}
+
+mmoore::InstructionSet mmoore::parse_instruction_set(const std::string &name) {
+   std::string normalized;
+
+   for (char c : name) {
+      if (std::isalnum(static_cast<unsigned char>(c))) {
+         normalized += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+      }
+   }
+
+   if (normalized == "scalar" || normalized == "none") return InstructionSet::Scalar;
+   if (normalized == "sse2" || normalized == "baseline") return InstructionSet::SSE2;
+   if (normalized == "sse42") return InstructionSet::SSE42;
+   if (normalized == "avx2") return InstructionSet::AVX2;
+   if (normalized == "avx512") return InstructionSet::AVX512;
+
+   return InstructionSet::Automatic;
+}
+
+const char *mmoore::to_string(InstructionSet instruction_set) {
+   switch (instruction_set) {
+      case InstructionSet::Scalar: return "scalar";
+      case InstructionSet::SSE2: return "sse2";
+      case InstructionSet::SSE42: return "sse4.2";
+      case InstructionSet::AVX2: return "avx2";
+      case InstructionSet::AVX512: return "avx512";
+      default: return "automatic";
+   }
+}
@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "debug_logging.hpp"
+#include "mmoore/cpu_topology.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <cstdint>
+
+#if defined(__linux__)
+   #include <fstream>
+   #include <set>
+   #include <string>
+   #include <utility>
+   #include <unistd.h>
+#elif defined(__APPLE__)
+   #include <sys/sysctl.h>
+   #include <sys/types.h>
+#elif defined(_WIN32)
+   #ifndef NOMINMAX
+      #define NOMINMAX
+   #endif
+   #ifndef WIN32_LEAN_AND_MEAN
+      #define WIN32_LEAN_AND_MEAN
+   #endif
+   #include <windows.h>
+   #include <vector>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+   template <typename T>
+   bool read_sysfs(const std::string &path, T &value) {
+      std::ifstream file(path);
+      return static_cast<bool>(file >> value);
+   }
+
+   // "2048K" -> 2097152
+   size_t parse_cache_size(const std::string &text) {
+      size_t value = 0;
+      size_t i = 0;
+
+      for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+         value = value * 10 + static_cast<size_t>(text[i] - '0');
+      }
+
+      if (i < text.size()) {
+         if (text[i] == 'K') value <<= 10;
+         else if (text[i] == 'M') value <<= 20;
+         else if (text[i] == 'G') value <<= 30;
+      }
+
+      return value;
+   }
+
+   void query_topology(mmoore::CpuTopology &topology) {
+      const std::string cpu_root = "/sys/devices/system/cpu/";
+
+      // logical cores sharing a (package, core) pair are hyperthreads of one physical core
+      std::set<std::pair<int, int>> cores;
+
+      for (unsigned cpu = 0; cpu < topology.logical_cores; ++cpu) {
+         const std::string topology_dir = cpu_root + "cpu" + std::to_string(cpu) + "/topology/";
+         int package = 0;
+         int core = 0;
+
+         if (read_sysfs(topology_dir + "physical_package_id", package) && read_sysfs(topology_dir + "core_id", core)) {
+            cores.insert({ package, core });
+         }
+      }
+
+      if (!cores.empty()) {
+         topology.physical_cores = static_cast<unsigned>(cores.size());
+      }
+
+      for (int index = 0; index < 8; ++index) {
+         const std::string cache_dir = cpu_root + "cpu0/cache/index" + std::to_string(index) + "/";
+         int level = 0;
+         std::string type;
+         std::string size;
+
+         if (!read_sysfs(cache_dir + "level", level)) {
+            break;
+         }
+
+         if (!read_sysfs(cache_dir + "type", type) || type == "Instruction" || !read_sysfs(cache_dir + "size", size)) {
+            continue;
+         }
+
+         if (level == 2) topology.l2_cache_size = parse_cache_size(size);
+         else if (level == 3) topology.l3_cache_size = parse_cache_size(size);
+      }
+
+#if defined(_SC_LEVEL2_CACHE_SIZE) && defined(_SC_LEVEL3_CACHE_SIZE)
+      // sysfs may be unavailable (containers), glibc reads cpuid instead
+      if (topology.l2_cache_size == 0) {
+         topology.l2_cache_size = static_cast<size_t>(std::max(::sysconf(_SC_LEVEL2_CACHE_SIZE), 0L));
+      }
+
+      if (topology.l3_cache_size == 0) {
+         topology.l3_cache_size = static_cast<size_t>(std::max(::sysconf(_SC_LEVEL3_CACHE_SIZE), 0L));
+      }
+#endif
+   }
+
+#elif defined(__APPLE__)
+   template <typename T>
+   T read_sysctl(const char *name) {
+      T value = 0;
+      size_t length = sizeof(value);
+
+      return ::sysctlbyname(name, &value, &length, nullptr, 0) == 0 ? value : 0;
+   }
+
+   void query_topology(mmoore::CpuTopology &topology) {
+      if (auto cores = read_sysctl<int32_t>("hw.physicalcpu"); cores > 0) {
+         topology.physical_cores = static_cast<unsigned>(cores);
+      }
+
+      // Apple silicon reports the cache of its performance cores under perflevel0
+      topology.l2_cache_size = static_cast<size_t>(read_sysctl<int64_t>("hw.perflevel0.l2cachesize"));
+
+      if (topology.l2_cache_size == 0) {
+         topology.l2_cache_size = static_cast<size_t>(read_sysctl<int64_t>("hw.l2cachesize"));
+      }
+
+      topology.l3_cache_size = static_cast<size_t>(read_sysctl<int64_t>("hw.l3cachesize"));
+   }
+
+#elif defined(_WIN32)
+   void query_topology(mmoore::CpuTopology &topology) {
+      DWORD length = 0;
+      ::GetLogicalProcessorInformation(nullptr, &length);
+
+      std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> entries(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+
+      if (entries.empty() || !::GetLogicalProcessorInformation(entries.data(), &length)) {
+         return;
+      }
+
+      unsigned cores = 0;
+
+      for (const auto &entry : entries) {
+         if (entry.Relationship == RelationProcessorCore) {
+            ++cores;
+         }
+         else if (entry.Relationship == RelationCache && entry.Cache.Type != CacheInstruction) {
+            if (entry.Cache.Level == 2) topology.l2_cache_size = entry.Cache.Size;
+            else if (entry.Cache.Level == 3) topology.l3_cache_size = entry.Cache.Size;
+         }
+      }
+
+      if (cores > 0) {
+         topology.physical_cores = cores;
+      }
+   }
+
+#else
+   void query_topology(mmoore::CpuTopology &) {}
+#endif
+
+   mmoore::CpuTopology detect() {
+      mmoore::CpuTopology topology;
+      topology.logical_cores = std::max(std::thread::hardware_concurrency(), 1u);
+      topology.physical_cores = topology.logical_cores;
+
+      query_topology(topology);
+
+      topology.physical_cores = std::clamp(topology.physical_cores, 1u, topology.logical_cores);
+
+      MMOORE_LOG("CPU topology: ", topology.physical_cores, " cores (", topology.logical_cores, " threads), L2 = ", 
+         topology.l2_cache_size, ", L3 = ", topology.l3_cache_size);
+
+      return topology;
+   }
+}
+
+const mmoore::CpuTopology &mmoore::detect_cpu_topology() {
+   static const CpuTopology topology = detect();
+   return topology;
+}
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "mapped_file.hpp"
+#include "debug_logging.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__unix__) || defined(__APPLE__)
+   #define MMOORE_HAS_MMAP 1
+   #include <fcntl.h>
+   #include <sys/mman.h>
+   #include <sys/stat.h>
+   #include <unistd.h>
+#endif
+
+mmoore::MappedFile::MappedFile(const std::filesystem::path &path) {
+#if defined(MMOORE_HAS_MMAP)
+   const int fd = ::open(path.c_str(), O_RDONLY);
+   if (fd < 0) {
+      MMOORE_LOG("MappedFile: failed to open ", path);
+      return;
+   }
+
+   struct stat file_stat;
+   if (::fstat(fd, &file_stat) != 0 
+      || static_cast<uint64_t>(file_stat.st_size) > std::numeric_limits<size_t>::max()) {
+      ::close(fd);
+      return;
+   }
+
+   mapping_size = static_cast<uint64_t>(file_stat.st_size);
+
+   // mmap rejects empty ranges, and there's nothing to read anyway
+   if (mapping_size > 0) {
+      void *address = ::mmap(nullptr, static_cast<size_t>(mapping_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+      if (address == MAP_FAILED) {
+         MMOORE_LOG("MappedFile: mmap failed for ", path);
+         mapping_size = 0;
+         ::close(fd);
+         return;
+      }
+
+      mapping = static_cast<const uint8_t *>(address);
+   }
+
+   // the mapping keeps its own reference to the file
+   ::close(fd);
+   mapped = true;
+#else
+   (void)path;
+#endif
+}
+
+mmoore::MappedFile::~MappedFile() {
+#if defined(MMOORE_HAS_MMAP)
+   if (mapping != nullptr) {
+      ::munmap(const_cast<uint8_t *>(mapping), static_cast<size_t>(mapping_size));
+   }
+#endif
+}
+
+void mmoore::MappedFile::advise_sequential() const {
+#if defined(MMOORE_HAS_MMAP)
+   if (mapping != nullptr) {
+      ::madvise(const_cast<uint8_t *>(mapping), static_cast<size_t>(mapping_size), MADV_SEQUENTIAL);
+   }
+#endif
+}
+
+void mmoore::MappedFile::advise_will_need(uint64_t offset, uint64_t length) const {
+#if defined(MMOORE_HAS_MMAP)
+   if (mapping == nullptr || offset >= mapping_size) {
+      return;
+   }
+
+   // madvise wants a page aligned start
+   static const uint64_t page_size = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+   const uint64_t aligned_offset = offset - offset % page_size;
+   const uint64_t end = std::min(offset + length, mapping_size);
+
+   ::madvise(
+      const_cast<uint8_t *>(mapping + aligned_offset), 
+      static_cast<size_t>(end - aligned_offset), 
+      MADV_WILLNEED);
+#else
+   (void)offset;
+   (void)length;
+#endif
+}
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef MONKEY_CORE_MAPPED_FILE_HPP
+#define MONKEY_CORE_MAPPED_FILE_HPP
+
+#include <filesystem>
+#include <cstdint>
+
+namespace mmoore {
+
+   /**
+    * Read-only memory mapping of a whole file, so the workers scan straight out of the
+    * page cache. Mapping isn't available on every platform (or for every file), in which
+    * case is_mapped() is false and callers fall back to stream reads.
+    */
+   class MappedFile {
+   public:
+      explicit MappedFile(const std::filesystem::path &path);
+      ~MappedFile();
+
+      MappedFile(const MappedFile &) = delete;
+      MappedFile &operator=(const MappedFile &) = delete;
+
+      bool is_mapped() const { return mapped; }
+
+      // start of the mapping, nullptr for empty files
+      const uint8_t *data() const { return mapping; }
+
+      uint64_t size() const { return mapping_size; }
+
+      /**
+       * Hints that the mapping will be read front to back, so the kernel reads ahead
+       * aggressively and drops pages behind the readers.
+       */
+      void advise_sequential() const;
+
+      /**
+       * Starts reading the given range in the background, ahead of the worker that scans it.
+       */
+      void advise_will_need(uint64_t offset, uint64_t length) const;
+
+   private:
+      const uint8_t *mapping = nullptr;
+      uint64_t mapping_size = 0;
+      bool mapped = false;
+   };
+}
+
+#endif // MONKEY_CORE_MAPPED_FILE_HPP
@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "memory_utils.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+   #include <sys/resource.h>
+#endif
+
+uint64_t mmoore::peak_resident_set_size() {
+#if defined(__unix__) || defined(__APPLE__)
+   struct rusage usage;
+
+   if (::getrusage(RUSAGE_SELF, &usage) != 0) {
+      return 0;
+   }
+
+#if defined(__APPLE__)
+   return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+   // reported in kilobytes
+   return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+
+#else
+   return 0;
+#endif
+}
@@ -5,6 +5,7 @@
 
 #include <type_traits>
 #include <cstddef>
+#include <cstdint>
 
 /**
  * Aligns 'num' up to the next multiple of 'Alignment'.
@@ -22,4 +23,12 @@ constexpr T align_up(T num) {
    return (num + mask) & ~mask;
 }
 
+namespace mmoore {
+
+   /**
+    * Peak resident set size of the process so far, in bytes (0 where it can't be queried).
+    */
+   uint64_t peak_resident_set_size();
+}
+
 #endif // MONKEY_CORE_MEMORY_UTILS_HPP
@@ -2,12 +2,58 @@
 
 #include "mmoore/monkey_moore.hpp"
 #include "mmoore/text_utils.hpp"
+#include "simd_kernels.hpp"
 
 #include <algorithm>
 #include <limits>
 #include <stdexcept>
 #include <cassert>
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+   /**
+    * Drives a candidate scanner over every window start in [0, last_start] and
+    * invokes on_candidate for each window that passes both probes, in increasing order.
+    */
+   template <class Ty, class CandidateFn>
+   void scan_candidates(
+      mmoore::simd::CandidateScanner<Ty> scanner,
+      const Ty *data,
+      uint64_t last_start,
+      const mmoore::simd::ProbePair<Ty> &probes,
+      CandidateFn &&on_candidate
+   ) {
+      uint64_t candidates[mmoore::simd::candidate_buffer_size];
+      uint64_t position = 0;
+
+      while (position <= last_start) {
+         size_t count = 0;
+         position = scanner(data, position, last_start, probes, candidates, count);
+
+         for (size_t i = 0; i < count; ++i) {
+            on_candidate(candidates[i]);
+         }
+      }
+   }
+
+   /**
+    * Shift table index of the two relative differences ending at `last`, with the newest one in
+    * the low byte. 16-bit differences are truncated to their low byte, which keeps the table at
+    * 64K entries and still tells apart the small differences common in text.
+    */
+   template <mmoore::Endianness Order, class Ty>
+   inline uint32_t pair_index(const Ty *last) {
+      const Ty newest = mmoore::load_ordered<Order>(last);
+      const Ty middle = mmoore::load_ordered<Order>(last - 1);
+      const Ty oldest = mmoore::load_ordered<Order>(last - 2);
+
+      return static_cast<uint8_t>(newest - middle)
+         | static_cast<uint32_t>(static_cast<uint8_t>(middle - oldest)) << 8;
+   }
+}
 
 template <class Ty> 
 MonkeyMoore<Ty>::MonkeyMoore(
@@ -43,9 +89,83 @@ std::vector <typename MonkeyMoore<Ty>::result_type> MonkeyMoore<Ty>::search(
    const Ty *data, 
    uint64_t data_len
 ) {
-   return search_mode == simple_relative || search_mode == value_scan ?
-      monkey_moore(data, data_len) :
-      monkey_moore_wc(data, data_len);
+   std::vector<result_type> results;
+   search(data, data_len, [&results](const result_type &match) { results.push_back(match); });
+
+   return results;
+}
+
+template <class Ty>
+void MonkeyMoore<Ty>::search(
+   const Ty *data, 
+   uint64_t data_len,
+   sink_type sink
+) {
+   reads_swapped_data() 
+      ? search_in_order<mmoore::foreign_endianness>(data, data_len, sink) 
+      : search_in_order<mmoore::system_endianness>(data, data_len, sink);
+}
+
+template <class Ty>
+template <mmoore::Endianness Order>
+void MonkeyMoore<Ty>::search_in_order(
+   const Ty *data, 
+   uint64_t data_len,
+   sink_type sink
+) {
+   bool is_wildcard_search = search_mode == wildcard_relative;
+
+   // the vectorized filters need two literal characters to probe a relative difference
+   auto literal_count = is_wildcard_search 
+      ? keyword.size() - wildcards_count 
+      : keyword.size();
+
+   bool has_simd_kernels = mmoore::resolve_instruction_set(instruction_set) != mmoore::InstructionSet::Scalar;
+   bool is_scalar_algorithm = algorithm == SearchAlgorithm::BoyerMoore 
+      || algorithm == SearchAlgorithm::QGram 
+      || algorithm == SearchAlgorithm::BitParallel;
+
+   if (algorithm == SearchAlgorithm::BitParallel && !bit_parallel_masks.empty()) {
+      return monkey_moore_bndm<Order>(data, data_len, sink);
+   }
+
+   if (has_simd_kernels && literal_count >= 2 && !is_scalar_algorithm) {
+      return is_wildcard_search 
+         ? monkey_moore_wc_simd<Order>(data, data_len, sink) 
+         : monkey_moore_simd<Order>(data, data_len, sink);
+   }
+
+   // without vectorized kernels, wildcard keywords are fastest on the bit-parallel automaton
+   // and the others on the pair shifts
+   bool picks_scalar_strategy = !is_scalar_algorithm;
+
+   if (is_wildcard_search && !bit_parallel_masks.empty() && picks_scalar_strategy) {
+      return monkey_moore_bndm<Order>(data, data_len, sink);
+   }
+
+   if (!is_wildcard_search && !qgram_shift_table.empty() 
+      && (picks_scalar_strategy || algorithm == SearchAlgorithm::QGram)) {
+      return monkey_moore_qgram<Order>(data, data_len, sink);
+   }
+
+   return is_wildcard_search 
+      ? monkey_moore_wc<Order>(data, data_len, sink) 
+      : monkey_moore<Order>(data, data_len, sink);
+}
+
+template <class Ty>
+void MonkeyMoore<Ty>::set_algorithm(SearchAlgorithm algorithm) {
+   this->algorithm = algorithm;
+}
+
+template <class Ty>
+void MonkeyMoore<Ty>::set_instruction_set(mmoore::InstructionSet instruction_set) {
+   this->instruction_set = instruction_set;
+}
+
+template <class Ty>
+void MonkeyMoore<Ty>::set_byte_order(mmoore::Endianness byte_order) {
+   this->byte_order = byte_order;
 }
 
 /**
@@ -59,9 +179,7 @@ void MonkeyMoore<Ty>::initialize(
    keyword = search_keyword;
    custom_character_seq = char_seq;
 
-   // Multiplied by 2 to account for negative relative differences
-   long skip_table_size = static_cast<long>(std::numeric_limits<Ty>::max() + 1) * 2;
-   skip_table.assign(skip_table_size, 0);
+   skip_table.assign(size_t(1) << skip_table_bits, 0);
 
    bool has_wildcards = std::count(keyword.begin(), keyword.end(), wildcard) > 0;
 
@@ -97,6 +215,9 @@ void MonkeyMoore<Ty>::preprocess () {
    else {
       throw std::runtime_error("Invalid search mode flag: none");
    }
+
+   preprocess_bit_parallel();
+   preprocess_delta_anchor();
 }
 
 /**
@@ -119,26 +240,76 @@ void MonkeyMoore<Ty>::preprocess_no_wildcards() {
    std::fill(
       skip_table.begin(), 
       skip_table.end(), 
-      static_cast <int> (keyword_len - 1));
-
-   long skip_table_len = static_cast<long>(skip_table.size());
+      static_cast<uint8_t>(std::min<long>(keyword_len - 1, std::numeric_limits<uint8_t>::max())));
 
-   // negative indices are mapped on positions 0-255, and positive ones on 256-511
+   // each entry keeps the distance from the rightmost difference mapped to it to the
+   // last character in the keyword
    for (int i = keyword_len - 1; i >= 0; i--) {
-      int index = expected_diff[i] + std::numeric_limits<Ty>::max();
+      uint8_t &entry = skip_table[skip_table_index(expected_diff[i])];
+      entry = static_cast<uint8_t>(std::min<long>(entry, keyword_len - i - 1));
+   }
 
-      if (index >= 0 && index < skip_table_len) {
-         // if the skip value for the current index hasn't been set, 
-         // we set it to the current distance to the last character in the keyword
-         if (skip_table[index] == keyword_len - 1) {
-            skip_table[index] = static_cast <int> (keyword_len - i - 1);
-         }
-      }
-      else {
-         //TODO: add more informaton to error
-         throw std::runtime_error("Skip table index out of bounds");
+   // every position but the wrap-around is compared against the previous character
+   std::vector<int> compared_offset(keyword_len, -1);
+   compared_offset[0] = static_cast<int>(keyword_len - 1);
+
+   preprocess_good_suffix(compared_offset);
+   preprocess_qgrams();
+}
+
+/**
+ * Builds the Wu-Manber shift table over pairs of differences. Each entry holds how far the window
+ * can move when its last two differences map to it: the distance from the rightmost pair of the
+ * keyword with the same entry to the end of the keyword, keyword_len - 2 when only the newest
+ * difference lines up with the keyword's first one, or keyword_len - 1 otherwise. Entries shared
+ * by several pairs keep the smallest shift, so the table never skips a match.
+ */
+template <class Ty>
+void MonkeyMoore<Ty>::preprocess_qgrams() {
+   const long keyword_len = static_cast<long>(keyword.size());
+   qgram_shift_table.clear();
+
+   // a pair spans three characters
+   if (keyword_len < 3) {
+      return;
+   }
+
+   auto keyword_pair_index = [this](long last_index) {
+      return static_cast<uint8_t>(expected_diff[last_index])
+         | static_cast<uint32_t>(static_cast<uint8_t>(expected_diff[last_index - 1])) << 8;
+   };
+
+   const long max_shift = std::min<long>(keyword_len - 1, std::numeric_limits<uint8_t>::max());
+   qgram_shift_table.assign(size_t(1) << qgram_table_bits, static_cast<uint8_t>(max_shift));
+
+   // the window's last pair overhanging the keyword's start, only the newest difference is compared
+   // (the older one would be aligned with the wrap-around difference, which isn't adjacent)
+   const uint8_t first_diff = static_cast<uint8_t>(expected_diff[1]);
+
+   for (uint32_t older = 0; older <= std::numeric_limits<uint8_t>::max(); ++older) {
+      uint8_t &entry = qgram_shift_table[first_diff | older << 8];
+      entry = static_cast<uint8_t>(std::min<long>(entry, keyword_len - 2));
+   }
+
+   // pairs can't include the wrap-around difference at index 0
+   for (long e = 2; e < keyword_len; ++e) {
+      uint8_t &entry = qgram_shift_table[keyword_pair_index(e)];
+      entry = static_cast<uint8_t>(std::min<long>(entry, keyword_len - 1 - e));
+   }
+
+   // after a failed verification, moves to the previous pair with the same entry, or to where the
+   // newest difference would line up with the first one (the table entry can't tell them apart)
+   const uint32_t last_index = keyword_pair_index(keyword_len - 1);
+   qgram_rematch_shift = static_cast<int>(std::min<long>(keyword_len - 2, max_shift));
+
+   for (long e = keyword_len - 2; e >= 2; --e) {
+      if (keyword_pair_index(e) == last_index) {
+         qgram_rematch_shift = static_cast<int>(std::min<long>(qgram_rematch_shift, keyword_len - 1 - e));
+         break;
       }
    }
+
+   qgram_rematch_shift = std::max(qgram_rematch_shift, 1);
 }
 
 template <class Ty>
@@ -198,6 +369,11 @@ void MonkeyMoore<Ty>::preprocess_with_wildcards() {
 
    wildcards_count = keyword_len - static_cast<int>(valid_indices.size());
 
+   leading_wildcards_count = count_prefix_length(
+      case_normalized_keyword.begin(),
+      case_normalized_keyword.end(),
+      wildcard);
+
    // Step 3: 1-pass branchless bridging & relative difference calculation
 
    expected_diff.assign(keyword_len, 0);
@@ -247,32 +423,22 @@ void MonkeyMoore<Ty>::preprocess_with_wildcards() {
    }
 
    // Step 4: builds the skip table (Boyer-Moore bad-character rule)
+   // Only literal positions are indexed, and each difference keeps the distance from its
+   // rightmost occurrence to the end of the keyword. The search discounts the positions to
+   // the right of the mismatch, so the jump never moves past a potential match. Differences
+   // are indexed wrapped around the data type, as the search compares them.
    std::fill(
       skip_table.begin(), 
       skip_table.end(), 
-      static_cast<char> (keyword_len - 1));
-
-   long skip_table_len = static_cast<long>(skip_table.size());
+      static_cast<uint8_t>(std::min<long>(keyword_len - 1, std::numeric_limits<uint8_t>::max())));
 
    for (long i = keyword_len - 1; i > 0; --i) {
-      // negative indices are mapped on positions 0-255, and positive ones on 256-511
-      int index = expected_diff[i] + std::numeric_limits<Ty>::max();
-
-      if (index >= 0 && index < skip_table_len) {
-         // count the number of wildcards present in the range that starts in i + 1
-         auto remaining_wildcards_count = std::count(
-            case_normalized_keyword.begin() + i + 1, 
-            case_normalized_keyword.end(), 
-            wildcard);
-
-         // subtracts the number of wildcards from the regular jump value
-         skip_table[index] = static_cast <char> (
-            keyword_len - remaining_wildcards_count - i - 1);
-      }
-      else {
-         //TODO: add more informaton to error
-         throw std::runtime_error("Skip table index out of bounds");
+      if (!is_literal_map[i]) {
+         continue;
       }
+
+      uint8_t &entry = skip_table[skip_table_index(wc_expected_diff[i])];
+      entry = static_cast<uint8_t>(std::min<long>(entry, keyword_len - i - 1));
    }
 
    // Step 5: builds the wildcard skip table 
@@ -301,6 +467,176 @@ void MonkeyMoore<Ty>::preprocess_with_wildcards() {
          wildcard_skip_table[i] = static_cast<unsigned char>(normalized_value);
       }
    }
+
+   // Step 6: builds the good-suffix table
+   preprocess_good_suffix(wc_bridge_offset);
+}
+
+/**
+ * Builds the BNDM masks over the adjacent differences of the keyword. Position p of the pattern is
+ * the difference between characters p + 1 and p, and accepts any difference when either of them is
+ * a wildcard. Bridged differences across wildcards and the wrap-around difference can't be read
+ * from adjacent characters, so they're left to the verification of each candidate.
+ */
+template <class Ty>
+void MonkeyMoore<Ty>::preprocess_bit_parallel() {
+   const long symbol_count = static_cast<long>(keyword.size()) - 1;
+
+   bit_parallel_class.clear();
+   bit_parallel_masks.clear();
+
+   if (symbol_count < 1 || symbol_count > bit_parallel_max_symbols) {
+      return;
+   }
+
+   // differences the keyword never expects share class 0
+   bit_parallel_class.assign(static_cast<size_t>(std::numeric_limits<Ty>::max()) + 1, 0);
+   bit_parallel_masks.assign(1, 0);
+
+   uint64_t dont_care = 0;
+
+   for (long p = 0; p < symbol_count; ++p) {
+      const long k = p + 1;
+      const uint64_t bit = uint64_t(1) << (symbol_count - 1 - p);
+
+      if (search_mode == wildcard_relative && wc_bridge_offset[k] != -1) {
+         dont_care |= bit;
+         continue;
+      }
+
+      auto symbol = static_cast<Ty>(expected_diff[k]);
+
+      if (bit_parallel_class[symbol] == 0) {
+         bit_parallel_class[symbol] = static_cast<uint8_t>(bit_parallel_masks.size());
+         bit_parallel_masks.push_back(0);
+      }
+
+      bit_parallel_masks[bit_parallel_class[symbol]] |= bit;
+   }
+
+   for (auto &mask : bit_parallel_masks) {
+      mask |= dont_care;
+   }
+}
+
+/**
+ * Picks the anchor searched for in difference streams: the longest run of keyword positions
+ * whose difference is taken against the preceding character. Positions next to wildcards and
+ * the wrap-around difference aren't adjacent in the stream, so they're checked on verification.
+ */
+template <class Ty>
+void MonkeyMoore<Ty>::preprocess_delta_anchor() {
+   const long keyword_len = static_cast<long>(keyword.size());
+
+   delta_anchor_start = 0;
+   delta_anchor.clear();
+
+   long run_start = 1;
+
+   for (long k = 1; k <= keyword_len; ++k) {
+      bool is_adjacent = k < keyword_len 
+         && (search_mode != wildcard_relative || wc_bridge_offset[k] == -1);
+
+      if (is_adjacent) {
+         continue;
+      }
+
+      if (k - run_start > static_cast<long>(delta_anchor.size())) {
+         delta_anchor_start = run_start;
+         delta_anchor.assign(k - run_start, 0);
+
+         for (long i = run_start; i < k; ++i) {
+            delta_anchor[i - run_start] = static_cast<uint8_t>(expected_diff[i]);
+         }
+      }
+
+      run_start = k + 1;
+   }
+
+   // the scan looks for the largest difference of the anchor first, as text and most
+   // other data are dominated by small differences between neighbouring values
+   delta_anchor_key = 0;
+
+   for (size_t i = 1; i < delta_anchor.size(); ++i) {
+      int magnitude = std::abs(static_cast<int8_t>(delta_anchor[i]));
+
+      if (magnitude >= std::abs(static_cast<int8_t>(delta_anchor[delta_anchor_key]))) {
+         delta_anchor_key = i;
+      }
+   }
+}
+
+/**
+ * Builds the Boyer-Moore good-suffix table over the relative differences. good_suffix_table[i]
+ * is the smallest shift that doesn't contradict what a mismatch at position i revealed about
+ * the window: the differences matched to its right, and the mismatched difference itself.
+ *
+ * Matched differences between adjacent characters chain together, so a shifted keyword is
+ * ruled out when any of its (possibly bridged) differences lands on a chain that disagrees
+ * with it. Wildcards and the wrap-around difference give no usable information and are
+ * skipped, so the table is safe for both search modes. A mismatch on the wrap-around means
+ * everything else matched, so the keyword shifts by its period.
+ * @param compared_offset offset of the character each position is compared against
+ *    (negative for preceding characters, 0 for wildcards, positive for the wrap-around)
+ */
+template <class Ty>
+void MonkeyMoore<Ty>::preprocess_good_suffix(const std::vector<int> &compared_offset) {
+   const long keyword_len = static_cast<long>(keyword.size());
+
+   // prefix sums of the adjacent differences, and of the positions that break the chain
+   std::vector<long> chain_sum(keyword_len + 1, 0);
+   std::vector<long> chain_breaks(keyword_len + 1, 0);
+
+   for (long t = 0; t < keyword_len; ++t) {
+      bool is_adjacent = compared_offset[t] == -1;
+
+      chain_sum[t + 1] = chain_sum[t] + (is_adjacent ? expected_diff[t] : 0);
+      chain_breaks[t + 1] = chain_breaks[t] + (is_adjacent ? 0 : 1);
+   }
+
+   // conflict_end[j] bounds the mismatch positions for which a shift of j is ruled out:
+   // the keyword shifted by j contradicts a chain that lies entirely to their right
+   std::vector<long> conflict_end(keyword_len + 1, 0);
+
+   for (long j = 1; j < keyword_len; ++j) {
+      for (long q = 1; q + j < keyword_len; ++q) {
+         if (compared_offset[q] >= 0) {
+            continue;
+         }
+
+         long right = q + j;
+         long left = right + compared_offset[q];
+
+         if (chain_breaks[right + 1] != chain_breaks[left + 1]) {
+            continue;
+         }
+
+         // the wildcard search compares wrapped differences, so only a wrapped mismatch
+         // is a contradiction for both modes
+         Ty chain_diff = static_cast<Ty>(chain_sum[right + 1] - chain_sum[left + 1]);
+
+         if (chain_diff != static_cast<Ty>(expected_diff[q])) {
+            conflict_end[j] = std::max(conflict_end[j], left + 1);
+         }
+      }
+   }
+
+   good_suffix_table.assign(keyword_len, static_cast<int>(keyword_len));
+
+   for (long i = 0; i < keyword_len; ++i) {
+      for (long j = 1; j <= keyword_len; ++j) {
+         // the shifted keyword would expect the same difference that just mismatched
+         long q = i - j;
+         bool repeats_mismatch = compared_offset[i] < 0 && q > 0
+            && compared_offset[q] == compared_offset[i]
+            && expected_diff[q] == expected_diff[i];
+
+         if (i >= conflict_end[j] && !repeats_mismatch) {
+            good_suffix_table[i] = static_cast<int>(j);
+            break;
+         }
+      }
+   }
 }
 
 /**
@@ -311,33 +647,32 @@ void MonkeyMoore<Ty>::preprocess_with_wildcards() {
  * a consistent execution path for the primary comparison logic.
  * @param data Pointer to the start of the data buffer.
  * @param data_len The length of the data buffer.
- * @return std::vector<result_type> A vector of matches containing the offset and equivalency map.
+ * @param sink Receives each match (offset and encoding) as it is found.
  */
-template<class Ty>
-std::vector <typename MonkeyMoore<Ty>::result_type> MonkeyMoore<Ty>::monkey_moore(
+template <class Ty>
+template <mmoore::Endianness Order>
+void MonkeyMoore<Ty>::monkey_moore(
    const Ty *data, 
-   uint64_t data_len
+   uint64_t data_len,
+   sink_type sink
 ) {
-   using result_type = typename MonkeyMoore<Ty>::result_type;
-   using equivalency_map = typename MonkeyMoore<Ty>::equivalency_map;
-
-   std::vector <result_type> results;
-
    const long keyword_len = static_cast<long>(keyword.size());
-   const long skip_table_len = static_cast<long>(skip_table.size());
 
    const Ty *search_head = data;
    const Ty *data_end = data + data_len;
 
    int mismatched_rel_value = 0;
+   long mismatch_index = 0;
 
    // Helper lambda to calculate the relative difference between two positions.
    // Returns false immediately if the difference doesn't match the precomputed keyword table. 
    auto check_match = [&](long current_index, long previous_index) -> bool {
-      int diff = search_head[current_index] - search_head[previous_index];
+      int diff = mmoore::load_ordered<Order>(search_head + current_index) 
+         - mmoore::load_ordered<Order>(search_head + previous_index);
 
       if (diff != expected_diff[current_index]) {
          mismatched_rel_value = diff;
+         mismatch_index = current_index;
          return false;
       }
 
@@ -372,43 +707,380 @@ std::vector <typename MonkeyMoore<Ty>::result_type> MonkeyMoore<Ty>::monkey_moor
 
       
       if (!match_failed) {
-         equivalency_map result;
+         uint64_t match_position = static_cast<uint64_t>(std::distance(data, search_head));
+         sink({match_position, make_simple_encoding<Order>(search_head)});
+
+         search_head += keyword_len - 1;
+      }
+      else {
+         // Calculate jump distance based on the mismatched relative value. The skip table
+         // stores distances to the end of the keyword, so we discount the positions to the
+         // right of the mismatch, otherwise we could jump over valid matches.
+         long aligned_jump = skip_table[skip_table_index(mismatched_rel_value)] - (keyword_len - 1 - mismatch_index);
+         long jump_size = std::max<long>(aligned_jump, good_suffix_table[mismatch_index]);
+
+         search_head += jump_size;
+      }
+   }
+}
+
+/**
+ * @brief Performs a vectorized relative search on the data buffer.
+ * Candidate window starts are filtered in batches of 16/32 bytes by computing the
+ * delta stream at two probe positions with SIMD subtractions and comparing it against
+ * the expected relative differences. Surviving candidates are then verified with the
+ * exact (non-wrapping) scalar comparison, so the results are the same as monkey_moore().
+ * @param data Pointer to the start of the data buffer.
+ * @param data_len The length of the data buffer.
+ * @param sink Receives each match (offset and encoding) as it is found.
+ */
+template <class Ty>
+template <mmoore::Endianness Order>
+void MonkeyMoore<Ty>::monkey_moore_simd(
+   const Ty *data, 
+   uint64_t data_len,
+   sink_type sink
+) {
+
+   const uint64_t keyword_len = keyword.size();
+
+   if (data_len < keyword_len) {
+      return;
+   }
+
+   uint64_t next_allowed = 0;
+
+   // probes the first and last relative differences of the keyword
+   const long last_index = static_cast<long>(keyword_len) - 1;
+
+   mmoore::simd::ProbePair<Ty> probes = {
+      { 1, 0 },
+      static_cast<Ty>(expected_diff[1]),
+      { last_index, last_index - 1 },
+      static_cast<Ty>(expected_diff[last_index])
+   };
+
+   auto scanner = mmoore::simd::select_candidate_scanner<Ty, Order>(
+      mmoore::resolve_instruction_set(instruction_set));
+
+   scan_candidates(scanner, data, data_len - keyword_len, probes, [&](uint64_t candidate) {
+      // matches can't overlap the previous one (same semantics as the scalar search)
+      if (candidate >= next_allowed && is_simple_match<Order>(data + candidate)) {
+         sink({candidate, make_simple_encoding<Order>(data + candidate)});
+         next_allowed = candidate + keyword_len - 1;
+      }
+   });
+}
+
+/**
+ * @brief Performs a relative Wu-Manber search on the data buffer.
+ * The window is moved by the shift of its last two relative differences (see preprocess_qgrams),
+ * which stays close to the keyword length even when single differences are common in the data.
+ * Windows with a shift of zero end with the keyword's last pair and are verified in full.
+ * @param data Pointer to the start of the data buffer.
+ * @param data_len The length of the data buffer.
+ * @param sink Receives each match (offset and encoding) as it is found.
+ */
+template <class Ty>
+template <mmoore::Endianness Order>
+void MonkeyMoore<Ty>::monkey_moore_qgram(
+   const Ty *data, 
+   uint64_t data_len,
+   sink_type sink
+) {
+
+   const long keyword_len = static_cast<long>(keyword.size());
+
+   if (data_len < static_cast<uint64_t>(keyword_len)) {
+      return;
+   }
+
+   const uint8_t *shift_table = qgram_shift_table.data();
+   const Ty *search_head = data;
+   const Ty *last_start = data + data_len - keyword_len;
 
-         if (search_mode != value_scan) {
-            // for value scan we're only interested in the offset
+   while (search_head <= last_start) {
+      long jump_size = shift_table[pair_index<Order>(search_head + keyword_len - 1)];
 
-            if (custom_character_seq.empty()) {
-               int distance = *search_head - keyword[0];
+      if (jump_size == 0) {
+         if (is_simple_match<Order>(search_head)) {
+            uint64_t match_position = static_cast<uint64_t>(search_head - data);
+            sink({match_position, make_simple_encoding<Order>(search_head)});
 
-               result['A'] = static_cast <Ty> ('A' + distance);
-               result['a'] = static_cast <Ty> ('a' + distance);
+            jump_size = keyword_len - 1;
+         }
+         else {
+            jump_size = qgram_rematch_shift;
+         }
+      }
+
+      search_head += jump_size;
+   }
+}
+
+/**
+ * @brief Performs a bit-parallel (BNDM) relative search on the data buffer.
+ * Each window's differences are read right to left while a bitmask tracks the keyword positions
+ * where the suffix read so far still occurs. Wildcards accept every difference, so they don't
+ * shorten the shifts like they do in the skip tables. The window moves to the longest suffix that
+ * is also a prefix of the keyword, and complete matches are verified against the bridged and
+ * wrap-around differences the automaton doesn't track.
+ * @param data Pointer to the start of the data buffer.
+ * @param data_len The length of the data buffer.
+ * @param sink Receives each match (offset and encoding) as it is found.
+ */
+template <class Ty>
+template <mmoore::Endianness Order>
+void MonkeyMoore<Ty>::monkey_moore_bndm(
+   const Ty *data, 
+   uint64_t data_len,
+   sink_type sink
+) {
+
+   const long keyword_len = static_cast<long>(keyword.size());
+
+   if (data_len < static_cast<uint64_t>(keyword_len)) {
+      return;
+   }
+
+   const bool is_wildcard_search = search_mode == wildcard_relative;
+   const long symbol_count = keyword_len - 1;
+   const uint64_t prefix_bit = uint64_t(1) << (symbol_count - 1);
+   const long match_advance = std::max<long>(keyword_len - 1 - leading_wildcards_count, 1);
+
+   const uint8_t *classes = bit_parallel_class.data();
+   const uint64_t *masks = bit_parallel_masks.data();
+
+   const uint64_t last_start = data_len - keyword_len;
+   uint64_t window_start = 0;
+   uint64_t next_allowed = 0;
+
+   while (window_start <= last_start) {
+      const Ty *window = data + window_start;
+
+      long j = symbol_count;
+      long jump_size = symbol_count;
+      uint64_t state = ~uint64_t(0);
+
+      while (j > 0 && state != 0) {
+         const Ty diff = static_cast<Ty>(
+            mmoore::load_ordered<Order>(window + j) - mmoore::load_ordered<Order>(window + j - 1));
+
+         state &= masks[classes[diff]];
+         --j;
+
+         if (state & prefix_bit) {
+            if (j > 0) {
+               // the differences read so far start the keyword, so it may begin at j
+               jump_size = j;
             }
-            else {
-               int distance = *search_head - custom_character_index[keyword[0]];
+            else if (window_start >= next_allowed 
+               && (is_wildcard_search ? is_wildcard_match<Order>(window) : is_simple_match<Order>(window))) {
+               sink({window_start, is_wildcard_search 
+                  ? make_wildcard_encoding<Order>(window) 
+                  : make_simple_encoding<Order>(window)});
 
-               for (CharType c : custom_character_seq) {
-                  result[c] = static_cast<Ty>(custom_character_index[c] + distance);
-               }
+               next_allowed = window_start + match_advance;
             }
          }
 
-         long match_position = static_cast <long> (std::distance(data, search_head));
-         results.push_back({match_position, result});
-
-         search_head += keyword_len - 1;
+         state <<= 1;
       }
-      else {
-         // Calculate jump distance based on the mismatched relative value
-         int skip_table_index = mismatched_rel_value + static_cast<int>(std::numeric_limits<Ty>::max());
-         int jump_size = std::max<int>(skip_table[skip_table_index], 1);
 
-         search_head += jump_size;
+      window_start = std::max<uint64_t>(window_start + jump_size, next_allowed);
+   }
+}
+
+template <class Ty>
+void MonkeyMoore<Ty>::compute_delta_stream(
+   const Ty *data, 
+   uint64_t data_len, 
+   std::vector<uint8_t> &deltas,
+   mmoore::Endianness byte_order
+) {
+   deltas.resize(data_len > 0 ? data_len - 1 : 0);
+
+   // independent iterations, so the compiler turns this into packed subtractions
+   auto fill_deltas = [&](auto load) {
+      uint8_t *target = deltas.data();
+      for (uint64_t i = 0; i + 1 < data_len; ++i) {
+         target[i] = static_cast<uint8_t>(load(data + i + 1) - load(data + i));
       }
+   };
+
+   if (sizeof(Ty) > 1 && byte_order != mmoore::system_endianness) {
+      fill_deltas(mmoore::load_ordered<mmoore::foreign_endianness, Ty>);
    }
+   else {
+      fill_deltas(mmoore::load_ordered<mmoore::system_endianness, Ty>);
+   }
+}
+
+/**
+ * @brief Performs a relative search over a precomputed difference stream.
+ * The anchor (see preprocess_delta_anchor) is located by looking for its largest difference with
+ * memchr and comparing the rest with memcmp, so the scan runs on the C library's vectorized byte
+ * search. Every hit is verified with the same rules as the direct search, including
+ * non-overlapping matches.
+ * @param data Pointer to the start of the data buffer.
+ * @param deltas Packed difference stream of the data buffer.
+ * @param data_len The length of the data buffer.
+ * @return std::vector<result_type> A vector of matches containing the offset and encoding.
+ */
+template<class Ty>
+std::vector <typename MonkeyMoore<Ty>::result_type> MonkeyMoore<Ty>::search_delta_stream(
+   const Ty *data, 
+   const uint8_t *deltas,
+   uint64_t data_len
+) {
+   std::vector<result_type> results;
+   search_delta_stream(data, deltas, data_len, [&results](const result_type &match) { results.push_back(match); });
 
    return results;
 }
 
+template<class Ty>
+void MonkeyMoore<Ty>::search_delta_stream(
+   const Ty *data, 
+   const uint8_t *deltas,
+   uint64_t data_len,
+   sink_type sink
+) {
+   reads_swapped_data() 
+      ? search_delta_stream_in_order<mmoore::foreign_endianness>(data, deltas, data_len, sink) 
+      : search_delta_stream_in_order<mmoore::system_endianness>(data, deltas, data_len, sink);
+}
+
+template <class Ty>
+template <mmoore::Endianness Order>
+void MonkeyMoore<Ty>::search_delta_stream_in_order(
+   const Ty *data, 
+   const uint8_t *deltas,
+   uint64_t data_len,
+   sink_type sink
+) {
+   // nothing to anchor on, e.g. single characters or literals separated by wildcards
+   if (delta_anchor.empty()) {
+      return search_in_order<Order>(data, data_len, sink);
+   }
+
+   const uint64_t keyword_len = keyword.size();
+
+   if (data_len < keyword_len) {
+      return;
+   }
+
+   const bool is_wildcard_search = search_mode == wildcard_relative;
+   const uint64_t match_advance = std::max<uint64_t>(keyword_len - 1 - leading_wildcards_count, 1);
+
+   // the anchor starts at keyword position delta_anchor_start, which is
+   // delta delta_anchor_start - 1 of the window
+   const uint8_t *stream_begin = deltas + delta_anchor_start - 1;
+   const uint64_t window_count = data_len - keyword_len + 1;
+
+   const size_t anchor_len = delta_anchor.size();
+   const uint8_t key = delta_anchor[delta_anchor_key];
+
+   uint64_t next_allowed = 0;
+   uint64_t window_start = 0;
+
+   while (window_start < window_count) {
+      const uint8_t *key_begin = stream_begin + window_start + delta_anchor_key;
+      const auto *hit = static_cast<const uint8_t *>(std::memchr(key_begin, key, window_count - window_start));
+
+      if (hit == nullptr) {
+         break;
+      }
+
+      window_start = static_cast<uint64_t>(hit - stream_begin) - delta_anchor_key;
+      const Ty *window = data + window_start;
+
+      if (window_start >= next_allowed
+         && std::memcmp(stream_begin + window_start, delta_anchor.data(), anchor_len) == 0
+         && (is_wildcard_search ? is_wildcard_match<Order>(window) : is_simple_match<Order>(window))) {
+         sink({window_start, is_wildcard_search 
+            ? make_wildcard_encoding<Order>(window) 
+            : make_simple_encoding<Order>(window)});
+
+         next_allowed = window_start + match_advance;
+      }
+
+      window_start = std::max(window_start + 1, next_allowed);
+   }
+}
+
+/**
+ * Checks whether the window matches every relative difference of the keyword,
+ * including the wrap-around difference between the first and last characters.
+ */
+template <class Ty>
+template <mmoore::Endianness Order>
+bool MonkeyMoore<Ty>::is_simple_match(const Ty *window) const {
+   const long keyword_len = static_cast<long>(keyword.size());
+
+   for (long k = keyword_len - 1; k > 0; --k) {
+      if (mmoore::load_ordered<Order>(window + k) - mmoore::load_ordered<Order>(window + k - 1) != expected_diff[k]) {
+         return false;
+      }
+   }
+
+   return mmoore::load_ordered<Order>(window) - mmoore::load_ordered<Order>(window + keyword_len - 1) == expected_diff[0];
+}
+
+/**
+ * Computes the encoding of a match found by the simple relative search.
+ */
+template <class Ty>
+template <mmoore::Endianness Order>
+typename MonkeyMoore<Ty>::encoding_type MonkeyMoore<Ty>::make_simple_encoding(
+   const Ty *window
+) {
+   encoding_type result;
+
+   // for value scan we're only interested in the offset
+   if (search_mode == value_scan) {
+      return result;
+   }
+
+   if (custom_character_seq.empty()) {
+      int distance = mmoore::load_ordered<Order>(window) - keyword[0];
+
+      result.upper_base = static_cast <Ty> ('A' + distance);
+      result.base = static_cast <Ty> ('a' + distance);
+   }
+   else {
+      result.base = static_cast<Ty>(mmoore::load_ordered<Order>(window) - custom_character_index[keyword[0]]);
+   }
+
+   return result;
+}
+
+/**
+ * Builds the equivalency map of an encoding, only when it's asked for.
+ */
+template <class Ty>
+typename MonkeyMoore<Ty>::equivalency_map MonkeyMoore<Ty>::make_equivalency_map(
+   const encoding_type &encoding
+) const {
+   equivalency_map result;
+
+   if (search_mode == value_scan) {
+      return result;
+   }
+
+   if (custom_character_seq.empty()) {
+      result['A'] = encoding.upper_base;
+      result['a'] = encoding.base;
+   }
+   else {
+      for (CharType c : custom_character_seq) {
+         result[c] = static_cast<Ty>(custom_character_index.at(c) + encoding.base);
+      }
+   }
+
+   return result;
+}
+
 /**
  * @brief Performs a wildcard-aware Relative Boyer-Moore search on the data buffer.
  * This implementation utilizes a branchless, zero-allocation hot loop to maintain
@@ -420,129 +1092,202 @@ std::vector <typename MonkeyMoore<Ty>::result_type> MonkeyMoore<Ty>::monkey_moor
  * are routed through an offset-shifted skip table for fast, branch-free heuristic jumping.
  * @param data Pointer to the start of the data buffer.
  * @param data_len The length of the data buffer.
- * @return std::vector<result_type> A vector of matches containing the offset and equivalency map.
+ * @param sink Receives each match (offset and encoding) as it is found.
  */
-template<class Ty>
-std::vector <typename MonkeyMoore<Ty>::result_type> MonkeyMoore<Ty>::monkey_moore_wc(
+template <class Ty>
+template <mmoore::Endianness Order>
+void MonkeyMoore<Ty>::monkey_moore_wc(
    const Ty *data, 
-   uint64_t data_len
+   uint64_t data_len,
+   sink_type sink
 ) {
-   std::vector<result_type> results;
 
    long keyword_len = static_cast<long>(this->keyword.size());
-   long skip_table_len = static_cast<long>(skip_table.size());
 
    const Ty *search_head = data;
    const Ty *search_tail = data + keyword_len;
 
-   int leading_wildcards_count = count_prefix_length(
-      case_normalized_keyword.begin(),
-      case_normalized_keyword.end(),
-      wildcard);
-
-   // replace with.... = leading_wildcards_count??
-   long first_non_wildcard_index = 0;
-   while (first_non_wildcard_index < keyword_len && !is_literal_map[first_non_wildcard_index]) {
-      first_non_wildcard_index++;
-   }
-
    while (search_tail <= data + data_len) {
       int matches = 0;
-      int mismatched_rel_value = 0;
+      Ty mismatched_rel_value = 0;
 
       for (; matches < keyword_len; matches++) {
          int i = keyword_len - matches - 1;
 
          // fetch the previous value by bridging it using the precomputed stride
-         Ty current_value = search_head[i];
-         Ty previous_value = search_head[i + wc_bridge_offset[i]];
+         Ty current_value = mmoore::load_ordered<Order>(search_head + i);
+         Ty previous_value = mmoore::load_ordered<Order>(search_head + i + wc_bridge_offset[i]);
 
          // computes the unsigned difference between the current and bridged previous value  
          Ty current_diff = static_cast<Ty>(current_value - previous_value);
 
          // skip over wildcards while matching the current difference with the expected one
          if ((current_diff & wc_bitmask[i]) != wc_expected_diff[i]) {
-            // only compute signed relative difference on a mismatch 
-            // so we can use it as index for the skip_table
-            mismatched_rel_value = static_cast<int>(current_value) - static_cast<int>(previous_value);
+            // the skip table is indexed by the same wrapped differences
+            mismatched_rel_value = current_diff;
             break;
          }
       }
 
       if (matches == keyword_len) {
-         equivalency_map result;
-
-         // handles ascii values
-         if (custom_character_seq.empty()) {
-            int distance = static_cast<int>(*(search_head + first_non_wildcard_index))
-               - static_cast<int>(case_normalized_keyword[first_non_wildcard_index]);
-
-            // if the keyword does not contain case changes, then we need to guess the value
-            // of the corresponding character in the opposite case 
-            // (e.g. if key is "world", we must guess the value of A)
-            if (!has_case_change) {
-               result['A'] = static_cast <Ty> ('A' + distance);
-               result['a'] = static_cast <Ty> ('a' + distance);
-            }
-            else {
-               // if the keyword contains case changes, then we need to find the first occurrence of
-               // a character in the opposite case in order to compute its value
-               auto is_target = [this](CharType c) {
-                  return mostly_lowercase ? is_ascii_upper(c) : is_ascii_lower(c);
-               };
-
-               auto it = std::find_if(keyword.begin(), keyword.end(), is_target);
-               if (it == keyword.end()) {
-                  throw std::runtime_error("Unexpected end of keyword when finding characters of opposing case");
-               }
-
-               int first_oposing_case_index = static_cast<int>(std::distance(keyword.begin(), it));
-            
-               int oposing_case_char_distance = 
-                  static_cast<int>(*(search_head + first_oposing_case_index))
-                     - static_cast<int>(*it);
-
-               result['A'] = mostly_lowercase 
-                  ? static_cast <Ty> ('A' + oposing_case_char_distance) 
-                  : static_cast <Ty> ('A' + distance);
-
-               result['a'] = mostly_lowercase 
-                  ? static_cast <Ty> ('a' + distance) 
-                  : static_cast <Ty> ('a' + oposing_case_char_distance);
-            }
-         }
-         else {
-            int distance = static_cast<int>(*(search_head + first_non_wildcard_index))
-               - custom_character_index[keyword[first_non_wildcard_index]];
+         uint64_t offset = static_cast<uint64_t>(std::distance(data, search_head));
+         sink({offset, make_wildcard_encoding<Order>(search_head)});
 
-            for (CharType c : custom_character_seq) {
-               result[c] = static_cast <Ty> (custom_character_index[c] + distance);
-            }     
-         }
+         // keywords with a single literal after their leading wildcards (e.g. "Ab", normalized
+         // to "*b") would otherwise not move at all
+         long match_jump = std::max<long>(keyword_len - 1 - leading_wildcards_count, 1);
 
-         long offset = static_cast <long> (std::distance(data, search_head));
-         results.push_back(std::make_pair(offset, result));
-            
-         search_head += keyword_len - 1 - leading_wildcards_count;
-         search_tail += keyword_len - 1 - leading_wildcards_count;
+         search_head += match_jump;
+         search_tail += match_jump;
       }
       else {
          // Calculate jump distance based on the mismatched relative value and wildcard closest wildcard position
-         int skip_table_index = mismatched_rel_value + std::numeric_limits<Ty>::max();
+         long mismatch_index = keyword_len - matches - 1;
+         unsigned char wildcard_jump_value = wildcard_skip_table[mismatch_index];
+         long aligned_jump = skip_table[skip_table_index(mismatched_rel_value)] - (keyword_len - 1 - mismatch_index);
 
-         unsigned char wildcard_jump_value = 
-            wildcard_skip_table[keyword_len - matches - 1];
-
-         int jump_size = std::min<int>(
+         long bad_character_jump = std::min<long>(
             wildcard_jump_value, 
-            std::max<int>(skip_table[skip_table_index], 1));
+            std::max<long>(aligned_jump, 1));
+
+         long jump_size = std::max<long>(bad_character_jump, good_suffix_table[mismatch_index]);
 
          search_head += jump_size;
          search_tail += jump_size;
       }
    }
+}
 
-   return results;
+/**
+ * @brief Performs a vectorized wildcard-aware relative search on the data buffer.
+ * Candidates are filtered with two bridged probes: the last literal character against its
+ * predecessor (wc_bridge_offset) and the second literal character against the first one.
+ * Each probe is evaluated with shifted unaligned loads, so all the alignments of a batch
+ * are tested at once and wildcard positions never reach the filter. Survivors are verified
+ * with the same masked comparison used by monkey_moore_wc().
+ * @param data Pointer to the start of the data buffer.
+ * @param data_len The length of the data buffer.
+ * @param sink Receives each match (offset and encoding) as it is found.
+ */
+template <class Ty>
+template <mmoore::Endianness Order>
+void MonkeyMoore<Ty>::monkey_moore_wc_simd(
+   const Ty *data, 
+   uint64_t data_len,
+   sink_type sink
+) {
+
+   const uint64_t keyword_len = keyword.size();
+
+   if (data_len < keyword_len) {
+      return;
+   }
+
+   const long last_literal = static_cast<long>(find_last_index(is_literal_map.begin(), is_literal_map.end(), true));
+   const long first_literal = leading_wildcards_count;
+
+   long second_literal = first_literal + 1;
+   while (!is_literal_map[second_literal]) {
+      second_literal++;
+   }
+
+   mmoore::simd::ProbePair<Ty> probes = {
+      { second_literal, second_literal + wc_bridge_offset[second_literal] },
+      wc_expected_diff[second_literal],
+      { last_literal, last_literal + wc_bridge_offset[last_literal] },
+      wc_expected_diff[last_literal]
+   };
+
+   auto scanner = mmoore::simd::select_candidate_scanner<Ty, Order>(
+      mmoore::resolve_instruction_set(instruction_set));
+
+   uint64_t next_allowed = 0;
+
+   scan_candidates(scanner, data, data_len - keyword_len, probes, [&](uint64_t candidate) {
+      if (candidate >= next_allowed && is_wildcard_match<Order>(data + candidate)) {
+         sink({candidate, make_wildcard_encoding<Order>(data + candidate)});
+         next_allowed = candidate + keyword_len - 1 - leading_wildcards_count;
+      }
+   });
+}
+
+/**
+ * Checks whether the window matches every bridged relative difference of the keyword.
+ */
+template <class Ty>
+template <mmoore::Endianness Order>
+bool MonkeyMoore<Ty>::is_wildcard_match(const Ty *window) const {
+   const long keyword_len = static_cast<long>(keyword.size());
+
+   for (long i = keyword_len - 1; i >= 0; --i) {
+      Ty current_diff = static_cast<Ty>(
+         mmoore::load_ordered<Order>(window + i) - mmoore::load_ordered<Order>(window + i + wc_bridge_offset[i]));
+
+      if ((current_diff & wc_bitmask[i]) != wc_expected_diff[i]) {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+/**
+ * Computes the encoding of a match found by the wildcard-aware search.
+ */
+template <class Ty>
+template <mmoore::Endianness Order>
+typename MonkeyMoore<Ty>::encoding_type MonkeyMoore<Ty>::make_wildcard_encoding(
+   const Ty *window
+) {
+   encoding_type result;
+
+   const long first_non_wildcard_index = leading_wildcards_count;
+
+   // handles ascii values
+   if (custom_character_seq.empty()) {
+      int distance = static_cast<int>(mmoore::load_ordered<Order>(window + first_non_wildcard_index))
+         - static_cast<int>(case_normalized_keyword[first_non_wildcard_index]);
+
+      // if the keyword does not contain case changes, then we need to guess the value
+      // of the corresponding character in the opposite case 
+      // (e.g. if key is "world", we must guess the value of A)
+      if (!has_case_change) {
+         result.upper_base = static_cast <Ty> ('A' + distance);
+         result.base = static_cast <Ty> ('a' + distance);
+      }
+      else {
+         // if the keyword contains case changes, then we need to find the first occurrence of
+         // a character in the opposite case in order to compute its value
+         auto is_target = [this](CharType c) {
+            return mostly_lowercase ? is_ascii_upper(c) : is_ascii_lower(c);
+         };
+
+         auto it = std::find_if(keyword.begin(), keyword.end(), is_target);
+         if (it == keyword.end()) {
+            throw std::runtime_error("Unexpected end of keyword when finding characters of opposing case");
+         }
+
+         int first_oposing_case_index = static_cast<int>(std::distance(keyword.begin(), it));
+      
+         int oposing_case_char_distance = 
+            static_cast<int>(mmoore::load_ordered<Order>(window + first_oposing_case_index))
+               - static_cast<int>(*it);
+
+         result.upper_base = mostly_lowercase 
+            ? static_cast <Ty> ('A' + oposing_case_char_distance) 
+            : static_cast <Ty> ('A' + distance);
+
+         result.base = mostly_lowercase 
+            ? static_cast <Ty> ('a' + distance) 
+            : static_cast <Ty> ('a' + oposing_case_char_distance);
+      }
+   }
+   else {
+      result.base = static_cast <Ty> (mmoore::load_ordered<Order>(window + first_non_wildcard_index)
+         - custom_character_index[keyword[first_non_wildcard_index]]);
+   }
+
+   return result;
 }
 
 /**
@@ -585,4 +1330,33 @@ std::vector<int> MonkeyMoore<Ty>::compute_relative_values_char_seq(
 }
 
 template class MonkeyMoore<uint8_t>;
-template class MonkeyMoore<uint16_t>;
\ No newline at end of file
+template class MonkeyMoore<uint16_t>;
+
+// verification helpers used by MultiMonkeyMoore's automaton
+template bool MonkeyMoore<uint8_t>::is_simple_match<mmoore::Endianness::Little>(const uint8_t *) const;
+template bool MonkeyMoore<uint8_t>::is_simple_match<mmoore::Endianness::Big>(const uint8_t *) const;
+template bool MonkeyMoore<uint16_t>::is_simple_match<mmoore::Endianness::Little>(const uint16_t *) const;
+template bool MonkeyMoore<uint16_t>::is_simple_match<mmoore::Endianness::Big>(const uint16_t *) const;
+
+template MonkeyMoore<uint8_t>::encoding_type 
+MonkeyMoore<uint8_t>::make_simple_encoding<mmoore::Endianness::Little>(const uint8_t *);
+template MonkeyMoore<uint8_t>::encoding_type 
+MonkeyMoore<uint8_t>::make_simple_encoding<mmoore::Endianness::Big>(const uint8_t *);
+template MonkeyMoore<uint16_t>::encoding_type 
+MonkeyMoore<uint16_t>::make_simple_encoding<mmoore::Endianness::Little>(const uint16_t *);
+template MonkeyMoore<uint16_t>::encoding_type 
+MonkeyMoore<uint16_t>::make_simple_encoding<mmoore::Endianness::Big>(const uint16_t *);
+
+template bool MonkeyMoore<uint8_t>::is_wildcard_match<mmoore::Endianness::Little>(const uint8_t *) const;
+template bool MonkeyMoore<uint8_t>::is_wildcard_match<mmoore::Endianness::Big>(const uint8_t *) const;
+template bool MonkeyMoore<uint16_t>::is_wildcard_match<mmoore::Endianness::Little>(const uint16_t *) const;
+template bool MonkeyMoore<uint16_t>::is_wildcard_match<mmoore::Endianness::Big>(const uint16_t *) const;
+
+template MonkeyMoore<uint8_t>::encoding_type 
+MonkeyMoore<uint8_t>::make_wildcard_encoding<mmoore::Endianness::Little>(const uint8_t *);
+template MonkeyMoore<uint8_t>::encoding_type 
+MonkeyMoore<uint8_t>::make_wildcard_encoding<mmoore::Endianness::Big>(const uint8_t *);
+template MonkeyMoore<uint16_t>::encoding_type 
+MonkeyMoore<uint16_t>::make_wildcard_encoding<mmoore::Endianness::Little>(const uint16_t *);
+template MonkeyMoore<uint16_t>::encoding_type 
+MonkeyMoore<uint16_t>::make_wildcard_encoding<mmoore::Endianness::Big>(const uint16_t *);
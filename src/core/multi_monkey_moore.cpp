@@ -0,0 +1,348 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "mmoore/multi_monkey_moore.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <queue>
+#include <stdexcept>
+
+template <class Ty>
+MultiMonkeyMoore<Ty>::MultiMonkeyMoore(
+   const std::vector<std::vector<CharType>> &keywords,
+   CharType wildcard,
+   const std::vector<CharType> &char_seq
+) {
+   if (keywords.size() > std::numeric_limits<uint32_t>::max()) {
+      throw std::length_error("Too many keywords");
+   }
+
+   searchers.reserve(keywords.size());
+   anchor_start.reserve(keywords.size());
+   anchor_end.reserve(keywords.size());
+
+   for (const auto &keyword : keywords) {
+      if (keyword.empty()) {
+         throw std::invalid_argument("Keywords can't be empty");
+      }
+
+      auto keyword_id = static_cast<uint32_t>(searchers.size());
+      searchers.emplace_back(keyword, wildcard, char_seq);
+
+      const auto &searcher = searchers.back();
+      const long keyword_len = static_cast<long>(keyword.size());
+
+      // the longest run of literals (the whole keyword without wildcards), where the
+      // expected differences are the ones between adjacent characters
+      long run_start = 0;
+      long run_end = keyword_len - 1;
+
+      if (searcher.search_mode == MonkeyMoore<Ty>::wildcard_relative) {
+         run_end = -1;
+
+         for (long k = 0, current_start = 0; k < keyword_len; ++k) {
+            if (!searcher.is_literal_map[k]) {
+               current_start = k + 1;
+            }
+            else if (k - current_start > run_end - run_start) {
+               run_start = current_start;
+               run_end = k;
+            }
+         }
+      }
+
+      anchor_start.push_back(run_start);
+      anchor_end.push_back(run_end);
+
+      // a single literal has no relative difference to feed the automaton
+      if (run_end > run_start) {
+         automaton_keywords.push_back(keyword_id);
+      }
+      else {
+         fallback_keywords.push_back(keyword_id);
+      }
+   }
+
+   build_automaton();
+}
+
+template <class Ty>
+void MultiMonkeyMoore<Ty>::set_instruction_set(mmoore::InstructionSet instruction_set) {
+   this->instruction_set = instruction_set;
+
+   for (auto &searcher : searchers) {
+      searcher.set_instruction_set(instruction_set);
+   }
+}
+
+template <class Ty>
+void MultiMonkeyMoore<Ty>::set_byte_order(mmoore::Endianness byte_order) {
+   this->byte_order = byte_order;
+
+   for (auto &searcher : searchers) {
+      searcher.set_byte_order(byte_order);
+   }
+}
+
+/**
+ * Builds a deterministic Aho-Corasick automaton over the relative differences of each
+ * keyword's anchor, expected_diff[anchor_start + 1 .. anchor_end]. The wrap-around
+ * difference and the characters outside of the anchor aren't part of the pattern, they're
+ * checked when the hit is verified.
+ */
+template <class Ty>
+void MultiMonkeyMoore<Ty>::build_automaton() {
+   const size_t symbol_count = static_cast<size_t>(std::numeric_limits<Ty>::max()) + 1;
+
+   // Step 1: compacts the alphabet to the differences that appear in the keywords
+
+   symbol_class.assign(symbol_count, 0);
+   alphabet_size = 1;
+
+   for (uint32_t keyword_id : automaton_keywords) {
+      const auto &expected_diff = searchers[keyword_id].expected_diff;
+
+      for (long k = anchor_start[keyword_id] + 1; k <= anchor_end[keyword_id]; ++k) {
+         auto symbol = static_cast<Ty>(expected_diff[k]);
+
+         if (symbol_class[symbol] == 0) {
+            symbol_class[symbol] = alphabet_size++;
+         }
+      }
+   }
+
+   // Step 2: builds the trie
+
+   std::vector<std::map<uint32_t, uint32_t>> children(1);
+   std::vector<std::vector<uint32_t>> outputs(1);
+
+   for (uint32_t keyword_id : automaton_keywords) {
+      const auto &expected_diff = searchers[keyword_id].expected_diff;
+      uint32_t state = 0;
+
+      for (long k = anchor_start[keyword_id] + 1; k <= anchor_end[keyword_id]; ++k) {
+         uint32_t symbol = symbol_class[static_cast<Ty>(expected_diff[k])];
+         auto child = children[state].find(symbol);
+
+         if (child != children[state].end()) {
+            state = child->second;
+            continue;
+         }
+
+         auto next_state = static_cast<uint32_t>(children.size());
+         children[state][symbol] = next_state;
+         children.emplace_back();
+         outputs.emplace_back();
+         state = next_state;
+      }
+
+      outputs[state].push_back(keyword_id);
+   }
+
+   // Step 3: resolves the failure links breadth first, filling the missing transitions
+   // with the ones of the failure state and inheriting its outputs
+
+   const size_t state_count = children.size();
+
+   if (state_count * alphabet_size > std::numeric_limits<uint32_t>::max()) {
+      throw std::length_error("Keyword automaton is too large");
+   }
+
+   std::vector<uint32_t> next_state(state_count * alphabet_size, 0);
+   std::vector<uint32_t> failure(state_count, 0);
+   std::queue<uint32_t> pending;
+
+   for (const auto &[symbol, child] : children[0]) {
+      next_state[symbol] = child;
+      pending.push(child);
+   }
+
+   while (!pending.empty()) {
+      uint32_t state = pending.front();
+      pending.pop();
+
+      const uint32_t *fallback_row = &next_state[failure[state] * alphabet_size];
+      uint32_t *row = &next_state[state * alphabet_size];
+
+      std::copy(fallback_row, fallback_row + alphabet_size, row);
+
+      const auto &inherited = outputs[failure[state]];
+      outputs[state].insert(outputs[state].end(), inherited.begin(), inherited.end());
+
+      for (const auto &[symbol, child] : children[state]) {
+         failure[child] = fallback_row[symbol];
+         row[symbol] = child;
+         pending.push(child);
+      }
+   }
+
+   // Step 4: renumbers the states so the ones with outputs come last, and stores the
+   // transitions as row offsets. The scan then doesn't multiply on every symbol, and
+   // detects outputs with a single comparison.
+
+   std::vector<uint32_t> order;
+   order.reserve(state_count);
+
+   for (uint32_t state = 0; state < state_count; ++state) {
+      if (outputs[state].empty()) order.push_back(state);
+   }
+
+   const auto first_output_state = static_cast<uint32_t>(order.size());
+
+   for (uint32_t state = 0; state < state_count; ++state) {
+      if (!outputs[state].empty()) order.push_back(state);
+   }
+
+   std::vector<uint32_t> renumbered(state_count);
+
+   for (uint32_t state = 0; state < state_count; ++state) {
+      renumbered[order[state]] = state;
+   }
+
+   transitions.assign(state_count * alphabet_size, 0);
+
+   for (uint32_t state = 0; state < state_count; ++state) {
+      const uint32_t *row = &next_state[order[state] * alphabet_size];
+
+      for (uint32_t symbol = 0; symbol < alphabet_size; ++symbol) {
+         transitions[state * alphabet_size + symbol] = renumbered[row[symbol]] * alphabet_size;
+      }
+   }
+
+   first_output_row = first_output_state * alphabet_size;
+
+   // Step 5: flattens the output lists of the accepting states
+
+   output_begin.clear();
+   output_ids.clear();
+
+   for (uint32_t state = first_output_state; state < state_count; ++state) {
+      const auto &ids = outputs[order[state]];
+
+      output_begin.push_back(static_cast<uint32_t>(output_ids.size()));
+      output_ids.insert(output_ids.end(), ids.begin(), ids.end());
+   }
+
+   output_begin.push_back(static_cast<uint32_t>(output_ids.size()));
+}
+
+template <class Ty>
+std::vector<typename MultiMonkeyMoore<Ty>::result_type> MultiMonkeyMoore<Ty>::search(
+   const Ty *data,
+   uint64_t data_len
+) {
+   std::vector<result_type> results;
+   search(data, data_len, [&results](const result_type &match) { results.push_back(match); });
+
+   std::sort(results.begin(), results.end(), [](const result_type &a, const result_type &b) {
+      return a.offset != b.offset ? a.offset < b.offset : a.keyword_id < b.keyword_id;
+   });
+
+   return results;
+}
+
+template <class Ty>
+void MultiMonkeyMoore<Ty>::search(
+   const Ty *data,
+   uint64_t data_len,
+   sink_type sink
+) {
+   search_individually(fallback_keywords, data, data_len, sink);
+
+   bool has_simd_kernels = mmoore::resolve_instruction_set(instruction_set) != mmoore::InstructionSet::Scalar;
+
+   if (has_simd_kernels && automaton_keywords.size() <= vectorized_keyword_limit) {
+      search_individually(automaton_keywords, data, data_len, sink);
+   }
+   else if (sizeof(Ty) > 1 && byte_order != mmoore::system_endianness) {
+      search_automaton<mmoore::foreign_endianness>(data, data_len, sink);
+   }
+   else {
+      search_automaton<mmoore::system_endianness>(data, data_len, sink);
+   }
+}
+
+template <class Ty>
+void MultiMonkeyMoore<Ty>::search_individually(
+   const std::vector<uint32_t> &keyword_ids,
+   const Ty *data,
+   uint64_t data_len,
+   sink_type sink
+) {
+   for (uint32_t keyword_id : keyword_ids) {
+      searchers[keyword_id].search(data, data_len, [&](const auto &match) {
+         sink({match.offset, keyword_id, match.encoding});
+      });
+   }
+}
+
+template <class Ty>
+template <mmoore::Endianness Order>
+void MultiMonkeyMoore<Ty>::search_automaton(
+   const Ty *data,
+   uint64_t data_len,
+   sink_type sink
+) {
+   // matches of the same keyword can't overlap (same semantics as MonkeyMoore), and a
+   // keyword's hits come in order of their window's start, as its anchor has a fixed position
+   std::vector<uint64_t> next_allowed(searchers.size(), 0);
+
+   const uint32_t *rows = transitions.data();
+   const uint32_t *classes = symbol_class.data();
+   uint32_t row = 0;
+
+   for (uint64_t i = 1; i < data_len; ++i) {
+      const Ty diff = static_cast<Ty>(mmoore::load_ordered<Order>(data + i) - mmoore::load_ordered<Order>(data + i - 1));
+      row = rows[row + classes[diff]];
+
+      if (row < first_output_row) {
+         continue;
+      }
+
+      const uint32_t accepting_state = (row - first_output_row) / alphabet_size;
+
+      for (uint32_t o = output_begin[accepting_state]; o < output_begin[accepting_state + 1]; ++o) {
+         uint32_t keyword_id = output_ids[o];
+         auto &searcher = searchers[keyword_id];
+         const uint64_t keyword_len = searcher.keyword.size();
+
+         // the automaton consumed the difference ending at i, so the anchor ends at i
+         if (i < static_cast<uint64_t>(anchor_end[keyword_id])) {
+            continue;
+         }
+
+         // the rest of the keyword may run past the end of the data
+         uint64_t window_start = i - anchor_end[keyword_id];
+
+         if (window_start < next_allowed[keyword_id] || window_start + keyword_len > data_len) {
+            continue;
+         }
+
+         const Ty *window = data + window_start;
+
+         if (searcher.search_mode == MonkeyMoore<Ty>::simple_relative) {
+            if (searcher.template is_simple_match<Order>(window)) {
+               sink({window_start, keyword_id, searcher.template make_simple_encoding<Order>(window)});
+               next_allowed[keyword_id] = window_start + keyword_len - 1;
+            }
+         }
+         else if (searcher.template is_wildcard_match<Order>(window)) {
+            sink({window_start, keyword_id, searcher.template make_wildcard_encoding<Order>(window)});
+            next_allowed[keyword_id] = window_start
+               + std::max<uint64_t>(keyword_len - 1 - searcher.leading_wildcards_count, 1);
+         }
+      }
+   }
+}
+
+template <class Ty>
+typename MultiMonkeyMoore<Ty>::equivalency_map MultiMonkeyMoore<Ty>::make_equivalency_map(
+   const encoding_type &encoding
+) const {
+   // every keyword shares the character sequence the map is built from
+   return searchers.empty() ? equivalency_map{} : searchers.front().make_equivalency_map(encoding);
+}
+
+template class MultiMonkeyMoore<uint8_t>;
+template class MultiMonkeyMoore<uint16_t>;
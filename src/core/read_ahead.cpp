@@ -0,0 +1,461 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "read_ahead.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <cassert>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+   #define MMOORE_HAS_IO_URING 1
+
+   #include <cerrno>
+   #include <cstring>
+   #include <linux/io_uring.h>
+   #include <sys/mman.h>
+   #include <sys/syscall.h>
+   #include <sys/uio.h>
+   #include <unistd.h>
+#endif
+
+/**
+ * Issues the read of a slot and waits for it. Reads of different slots may be in flight
+ * at the same time, a slot is only reused once its read has been waited for.
+ */
+class mmoore::ReadAheadQueue::Engine {
+public:
+   virtual ~Engine() = default;
+
+   virtual void start(size_t slot, uint64_t offset, uint8_t *target, size_t length) = 0;
+
+   // bytes read into the slot
+   virtual size_t wait(size_t slot) = 0;
+};
+
+/**
+ * Portable backend: a reader thread issues the positioned reads in submission order.
+ */
+class mmoore::ReadAheadQueue::ThreadEngine : public Engine {
+public:
+   ThreadEngine(FileReader &file_reader, size_t num_slots)
+      : reader(file_reader),
+        bytes_read(num_slots, 0),
+        completed(num_slots, false),
+        errors(num_slots),
+        reader_thread([this]() { read_loop(); }) {}
+
+   ~ThreadEngine() override {
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         stopping = true;
+      }
+
+      request_ready.notify_one();
+      reader_thread.join();
+   }
+
+   void start(size_t slot, uint64_t offset, uint8_t *target, size_t length) override {
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         completed[slot] = false;
+         requests.push_back({ slot, offset, target, length });
+      }
+
+      request_ready.notify_one();
+   }
+
+   size_t wait(size_t slot) override {
+      std::unique_lock<std::mutex> lock(mutex);
+      read_done.wait(lock, [&]() { return completed[slot]; });
+
+      if (errors[slot]) {
+         std::rethrow_exception(std::exchange(errors[slot], nullptr));
+      }
+
+      return bytes_read[slot];
+   }
+
+private:
+   struct Request {
+      size_t slot;
+      uint64_t offset;
+      uint8_t *target;
+      size_t length;
+   };
+
+   FileReader &reader;
+
+   std::mutex mutex;
+   std::condition_variable request_ready;
+   std::condition_variable read_done;
+   std::deque<Request> requests;
+   std::vector<size_t> bytes_read;
+   std::vector<bool> completed;
+
+   // failed reads, rethrown on the worker by wait()
+   std::vector<std::exception_ptr> errors;
+   bool stopping = false;
+
+   // started last, once everything it touches is constructed
+   std::thread reader_thread;
+
+   void read_loop() {
+      std::unique_lock<std::mutex> lock(mutex);
+
+      while (true) {
+         request_ready.wait(lock, [&]() { return stopping || !requests.empty(); });
+
+         if (requests.empty()) {
+            return;
+         }
+
+         Request request = requests.front();
+         requests.pop_front();
+
+         lock.unlock();
+         size_t count = 0;
+         std::exception_ptr error;
+
+         try {
+            count = reader.read_at(request.offset, request.target, request.length);
+         }
+         catch (...) {
+            error = std::current_exception();
+         }
+
+         lock.lock();
+
+         bytes_read[request.slot] = count;
+         errors[request.slot] = error;
+         completed[request.slot] = true;
+         read_done.notify_one();
+      }
+   }
+};
+
+#if defined(MMOORE_HAS_IO_URING)
+
+/**
+ * Linux backend: reads are queued on an io_uring owned by the worker, so they need neither
+ * a thread nor a system call each to complete. Reads the kernel rejects or cuts short are
+ * finished with pread.
+ */
+class mmoore::ReadAheadQueue::IoUringEngine : public Engine {
+public:
+   // nullptr when the kernel doesn't support io_uring (or it's disabled)
+   static std::unique_ptr<IoUringEngine> create(FileReader &file_reader, size_t num_slots) {
+      std::unique_ptr<IoUringEngine> ring(new IoUringEngine(file_reader, num_slots));
+      return ring->ring_fd >= 0 ? std::move(ring) : nullptr;
+   }
+
+   ~IoUringEngine() override {
+      if (sqes != nullptr) {
+         ::munmap(sqes, sqes_size);
+      }
+
+      if (cq_ring != nullptr && cq_ring != sq_ring) {
+         ::munmap(cq_ring, cq_ring_size);
+      }
+
+      if (sq_ring != nullptr) {
+         ::munmap(sq_ring, sq_ring_size);
+      }
+
+      if (ring_fd >= 0) {
+         ::close(ring_fd);
+      }
+   }
+
+   void start(size_t slot, uint64_t offset, uint8_t *target, size_t length) override {
+      requests[slot] = { offset, target, length };
+      iovecs[slot] = { target, length };
+      completed[slot] = false;
+
+      if (!submission_failed) {
+         // the worker is the only producer, so the tail can't move under us
+         const unsigned tail = *sq_tail;
+         const unsigned index = tail & *sq_mask;
+
+         io_uring_sqe &sqe = sqes[index];
+         std::memset(&sqe, 0, sizeof(sqe));
+         sqe.opcode = IORING_OP_READV;
+         sqe.fd = reader.native_handle();
+         sqe.off = offset;
+         sqe.addr = reinterpret_cast<uint64_t>(&iovecs[slot]);
+         sqe.len = 1;
+         sqe.user_data = slot;
+
+         sq_array[index] = index;
+         __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+         if (enter(1, 0, 0) >= 0) {
+            return;
+         }
+
+         // the entry stays unsubmitted from now on, as the ring is never entered with
+         // anything to submit again
+         submission_failed = true;
+      }
+
+      bytes_read[slot] = reader.read_at(offset, target, length);
+      completed[slot] = true;
+   }
+
+   size_t wait(size_t slot) override {
+      while (!completed[slot]) {
+         reap();
+      }
+
+      if (errors[slot]) {
+         std::rethrow_exception(std::exchange(errors[slot], nullptr));
+      }
+
+      return bytes_read[slot];
+   }
+
+private:
+   struct Request {
+      uint64_t offset;
+      uint8_t *target;
+      size_t length;
+   };
+
+   FileReader &reader;
+   int ring_fd = -1;
+
+   void *sq_ring = nullptr;
+   void *cq_ring = nullptr;
+   size_t sq_ring_size = 0;
+   size_t cq_ring_size = 0;
+
+   io_uring_sqe *sqes = nullptr;
+   size_t sqes_size = 0;
+
+   unsigned *sq_tail = nullptr;
+   unsigned *sq_mask = nullptr;
+   unsigned *sq_array = nullptr;
+   unsigned *cq_head = nullptr;
+   unsigned *cq_tail = nullptr;
+   unsigned *cq_mask = nullptr;
+   io_uring_cqe *cqes = nullptr;
+
+   std::vector<Request> requests;
+   std::vector<iovec> iovecs;
+   std::vector<size_t> bytes_read;
+   std::vector<bool> completed;
+
+   // failed reads of completed slots, rethrown by wait()
+   std::vector<std::exception_ptr> errors;
+   bool submission_failed = false;
+
+   IoUringEngine(FileReader &file_reader, size_t num_slots)
+      : reader(file_reader),
+        requests(num_slots),
+        iovecs(num_slots),
+        bytes_read(num_slots, 0),
+        completed(num_slots, false),
+        errors(num_slots) {
+      io_uring_params params;
+      std::memset(&params, 0, sizeof(params));
+
+      ring_fd = static_cast<int>(::syscall(__NR_io_uring_setup, static_cast<unsigned>(num_slots), &params));
+
+      if (ring_fd < 0) {
+         return;
+      }
+
+      sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+      cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+      const bool single_mapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+      if (single_mapping) {
+         sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+      }
+
+      sq_ring = map_ring(sq_ring_size, IORING_OFF_SQ_RING);
+      cq_ring = single_mapping ? sq_ring : map_ring(cq_ring_size, IORING_OFF_CQ_RING);
+
+      sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+      sqes = static_cast<io_uring_sqe *>(map_ring(sqes_size, IORING_OFF_SQES));
+
+      if (sq_ring == nullptr || cq_ring == nullptr || sqes == nullptr) {
+         ::close(ring_fd);
+         ring_fd = -1;
+         return;
+      }
+
+      auto *sq = static_cast<uint8_t *>(sq_ring);
+      auto *cq = static_cast<uint8_t *>(cq_ring);
+
+      sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+      sq_mask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+      sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+      cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+      cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+      cq_mask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+      cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+   }
+
+   void *map_ring(size_t size, off_t region) {
+      void *ring = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, region);
+      return ring != MAP_FAILED ? ring : nullptr;
+   }
+
+   int enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+      while (true) {
+         long result = ::syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0);
+
+         if (result >= 0 || (errno != EINTR && errno != EAGAIN)) {
+            return static_cast<int>(result);
+         }
+      }
+   }
+
+   // collects one completion, blocking until there is one
+   void reap() {
+      const unsigned head = *cq_head;
+
+      if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+         // retrying a ring that can't be waited on would spin the worker forever
+         if (enter(0, 1, IORING_ENTER_GETEVENTS) < 0) {
+            throw std::system_error(errno, std::generic_category(), "Failed to wait for a read");
+         }
+
+         return;
+      }
+
+      const io_uring_cqe &cqe = cqes[head & *cq_mask];
+      const size_t slot = static_cast<size_t>(cqe.user_data);
+      const int result = cqe.res;
+
+      __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+
+      const Request &request = requests[slot];
+      size_t count = result > 0 ? static_cast<size_t>(result) : 0;
+
+      // rejected (result < 0) or short reads are finished synchronously, a read of
+      // nothing is the end of the file. Reads that fail again fail the slot
+      if (result < 0 || (result > 0 && count < request.length)) {
+         try {
+            count += reader.read_at(request.offset + count, request.target + count, request.length - count);
+         }
+         catch (...) {
+            errors[slot] = std::current_exception();
+         }
+      }
+
+      bytes_read[slot] = count;
+      completed[slot] = true;
+   }
+};
+
+#endif
+
+mmoore::ReadAheadQueue::ReadAheadQueue(
+   const std::filesystem::path &path,
+   size_t queue_depth,
+   ReadAheadBackend backend,
+   bool huge_pages,
+   bool bypass_cache
+) : reader(path, bypass_cache),
+    slots(queue_depth == 0 ? 1 : queue_depth + 1),
+    max_in_flight(std::max<size_t>(queue_depth, 1)),
+    huge_pages(huge_pages) {
+   if (queue_depth == 0 || backend == ReadAheadBackend::None) {
+      return;
+   }
+
+#if defined(MMOORE_HAS_IO_URING)
+   if (backend != ReadAheadBackend::Thread) {
+      engine = IoUringEngine::create(reader, slots.size());
+
+      if (engine) {
+         active_backend = ReadAheadBackend::IoUring;
+         return;
+      }
+   }
+#endif
+
+   engine = std::make_unique<ThreadEngine>(reader, slots.size());
+   active_backend = ReadAheadBackend::Thread;
+}
+
+mmoore::ReadAheadQueue::~ReadAheadQueue() {
+   while (engine && pending > 0) {
+      // the search already failed (or is done with these blocks), only the buffers matter
+      try {
+         engine->wait(oldest);
+      }
+      catch (...) {}
+
+      oldest = (oldest + 1) % slots.size();
+      --pending;
+   }
+}
+
+bool mmoore::ReadAheadQueue::can_submit() const {
+   return pending < max_in_flight && pending + (holding ? 1 : 0) < slots.size();
+}
+
+void mmoore::ReadAheadQueue::submit(uint64_t offset, size_t length, size_t tag) {
+   assert(can_submit());
+
+   const size_t index = (oldest + pending) % slots.size();
+   Slot &slot = slots[index];
+
+   const size_t alignment = reader.alignment();
+
+   slot.lead = static_cast<size_t>(offset % alignment);
+   slot.offset = offset - slot.lead;
+   slot.length = (slot.lead + length + alignment - 1) / alignment * alignment;
+   slot.requested = length;
+   slot.tag = tag;
+
+   if (slot.buffer.reserve(slot.length, huge_pages)) {
+      allocations += 1;
+      bytes_allocated += slot.buffer.capacity();
+   }
+
+   reader.find_cached(slot.offset, slot.length, slot.resident);
+
+   // synchronous reads are issued by next()
+   if (engine) {
+      engine->start(index, slot.offset, slot.buffer.data(), slot.length);
+   }
+
+   ++pending;
+}
+
+mmoore::ReadAheadQueue::Block mmoore::ReadAheadQueue::next() {
+   assert(pending > 0);
+
+   release();
+
+   Slot &slot = slots[oldest];
+
+   const auto wait_start = std::chrono::steady_clock::now();
+
+   const size_t bytes_read = engine
+      ? engine->wait(oldest)
+      : reader.read_at(slot.offset, slot.buffer.data(), slot.length);
+
+   io_wait += std::chrono::steady_clock::now() - wait_start;
+
+   reader.drop_cached(slot.offset, bytes_read, slot.resident);
+
+   oldest = (oldest + 1) % slots.size();
+   --pending;
+   holding = true;
+
+   // the aligned read may stop short of the lead at the end of the file, or run past the request
+   const size_t size = std::min(slot.requested, bytes_read - std::min(bytes_read, slot.lead));
+
+   return { slot.tag, slot.buffer.data() + slot.lead, size };
+}
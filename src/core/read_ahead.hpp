@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef MONKEY_CORE_READ_AHEAD_HPP
+#define MONKEY_CORE_READ_AHEAD_HPP
+
+#include "block_io.hpp"
+#include "mmoore/search_engine.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+namespace mmoore {
+
+   /**
+    * Reads a worker's upcoming blocks in the background while it scans the current one.
+    * Reads complete in submission order; each one lands in its own reused slot buffer,
+    * so up to queue_depth reads are in flight while a block is scanned.
+    */
+   class ReadAheadQueue {
+   public:
+      struct Block {
+         size_t tag;
+         const uint8_t *data;
+
+         // bytes actually read, short only at the end of the file
+         size_t size;
+      };
+
+      /**
+       * @param queue_depth reads kept in flight ahead of the scanned block (0 reads synchronously)
+       * @param backend preferred way of issuing the reads, falls back to a reader thread
+       *        when io_uring isn't available
+       * @param huge_pages backs the slot buffers with huge pages (see AlignedBuffer::reserve)
+       * @param bypass_cache reads around the page cache (see FileReader)
+       * @throws std::runtime_error if the file can't be opened
+       */
+      ReadAheadQueue(
+         const std::filesystem::path &path,
+         size_t queue_depth,
+         ReadAheadBackend backend,
+         bool huge_pages = false,
+         bool bypass_cache = false
+      );
+
+      // waits for the reads still in flight, which target the slot buffers
+      ~ReadAheadQueue();
+
+      ReadAheadQueue(const ReadAheadQueue &) = delete;
+      ReadAheadQueue &operator=(const ReadAheadQueue &) = delete;
+
+      // whether another read can be submitted without waiting
+      bool can_submit() const;
+
+      // whether there are no submitted reads left to collect with next()
+      bool empty() const { return pending == 0; }
+
+      /**
+       * Starts reading length bytes at offset. Must only be called when can_submit() is true.
+       * @param tag returned with the data by next()
+       * @throws std::system_error if the read has to be issued synchronously and fails
+       */
+      void submit(uint64_t offset, size_t length, size_t tag);
+
+      /**
+       * Waits for the oldest submitted read. Its data stays valid until release() (or the
+       * next call), which hands the slot back to submit().
+       * @throws std::system_error if the read fails
+       */
+      Block next();
+
+      void release() { holding = false; }
+
+      // how the reads are actually issued (None when they are synchronous)
+      ReadAheadBackend backend() const { return active_backend; }
+
+      // whether the reads bypass the page cache with direct I/O
+      bool is_direct() const { return reader.alignment() > 1; }
+
+      // time spent in next() waiting for the data
+      std::chrono::nanoseconds io_wait_time() const { return io_wait; }
+
+      uint64_t buffer_allocations() const { return allocations; }
+      uint64_t buffer_bytes_allocated() const { return bytes_allocated; }
+
+   private:
+      // direct reads cover the requested range rounded out to the reader's alignment, the
+      // requested bytes start lead bytes into the buffer
+      struct Slot {
+         AlignedBuffer buffer;
+         uint64_t offset = 0;
+         size_t length = 0;
+         size_t lead = 0;
+         size_t requested = 0;
+         size_t tag = 0;
+
+         // pages of the range that were cached before the read (see FileReader::find_cached)
+         std::vector<uint8_t> resident;
+      };
+
+      // issues the reads of the slots, implemented per backend
+      class Engine;
+      class IoUringEngine;
+      class ThreadEngine;
+
+      FileReader reader;
+      std::unique_ptr<Engine> engine;
+      ReadAheadBackend active_backend = ReadAheadBackend::None;
+
+      std::vector<Slot> slots;
+      size_t max_in_flight;
+      size_t oldest = 0;
+      size_t pending = 0;
+      bool holding = false;
+      bool huge_pages;
+
+      std::chrono::nanoseconds io_wait{0};
+      uint64_t allocations = 0;
+      uint64_t bytes_allocated = 0;
+   };
+}
+
+#endif // MONKEY_CORE_READ_AHEAD_HPP
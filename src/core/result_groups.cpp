@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "mmoore/result_groups.hpp"
+
+#include <unordered_map>
+
+template<typename DataType>
+std::vector<mmoore::ResultGroup<DataType>> 
+mmoore::group_by_encoding(const std::vector<SearchResult<DataType>> &results) {
+   using EquivalencyMap = typename MonkeyMoore<DataType>::equivalency_map;
+
+   std::vector<ResultGroup<DataType>> groups;
+   std::unordered_map<const EquivalencyMap *, size_t> group_index;
+
+   for (size_t i = 0; i < results.size(); ++i) {
+      const auto &result = results[i];
+      auto [it, inserted] = group_index.try_emplace(result.values_map.get(), groups.size());
+
+      if (inserted) {
+         groups.push_back({ result.values_map, 0, result.offset, i, {} });
+      }
+
+      auto &group = groups[it->second];
+      group.count++;
+      group.offsets.push_back(result.offset);
+   }
+
+   return groups;
+}
+
+template<typename DataType>
+std::vector<mmoore::ResultGroup<DataType>> 
+mmoore::group_by_encoding(const ResultStore<DataType> &store) {
+   // the store numbers its encodings in order of appearance already
+   std::vector<ResultGroup<DataType>> groups(store.num_encodings());
+
+   for (size_t i = 0; i < store.size(); ++i) {
+      auto &group = groups[store.encoding_id(i)];
+
+      if (group.count++ == 0) {
+         group.values_map = store.equivalency_map_of(store.encoding_id(i));
+         group.first_offset = store.offset(i);
+         group.first_index = i;
+      }
+
+      group.offsets.push_back(store.offset(i));
+   }
+
+   return groups;
+}
+
+template std::vector<mmoore::ResultGroup<uint8_t>> 
+mmoore::group_by_encoding(const std::vector<SearchResult<uint8_t>> &);
+template std::vector<mmoore::ResultGroup<uint16_t>> 
+mmoore::group_by_encoding(const std::vector<SearchResult<uint16_t>> &);
+
+template std::vector<mmoore::ResultGroup<uint8_t>> 
+mmoore::group_by_encoding(const ResultStore<uint8_t> &);
+template std::vector<mmoore::ResultGroup<uint16_t>> 
+mmoore::group_by_encoding(const ResultStore<uint16_t> &);
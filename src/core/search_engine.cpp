@@ -3,13 +3,16 @@
 #include "encoding.hpp"
 #include "memory_utils.hpp"
 #include "debug_logging.hpp"
+#include "mapped_file.hpp"
+#include "thread_pool.hpp"
+#include "read_ahead.hpp"
+#include "mmoore/cpu_topology.hpp"
 #include "mmoore/byteswap.hpp"
 #include "mmoore/search_engine.hpp"
 
 #include <vector>
 #include <fstream>
 #include <cmath>
-#include <future>
 #include <algorithm>
 #include <filesystem>
 #include <mutex>
@@ -17,6 +20,8 @@
 #include <chrono>
 #include <unordered_map>
 #include <sstream>
+#include <cstring>
+#include <limits>
 
 #include <iostream>
 
@@ -26,19 +31,69 @@ mmoore::SearchEngine<DataType>::run(
    ProgressCallback on_progress, 
    std::atomic<bool> &abort_flag,
    bool generate_previews
+) {
+   return search(on_progress, abort_flag, generate_previews, Output::Results);
+}
+
+template <typename DataType>
+uint64_t mmoore::SearchEngine<DataType>::count(
+   ProgressCallback on_progress, 
+   std::atomic<bool> &abort_flag
+) {
+   search(on_progress, abort_flag, false, Output::Count);
+   return run_stats.matches;
+}
+
+template <typename DataType>
+std::vector<mmoore::EncodingCount<DataType>> 
+mmoore::SearchEngine<DataType>::count_by_encoding(
+   ProgressCallback on_progress, 
+   std::atomic<bool> &abort_flag
+) {
+   search(on_progress, abort_flag, false, Output::EncodingCounts);
+   return std::move(encoding_counts);
+}
+
+template <typename DataType>
+mmoore::ResultStore<DataType> 
+mmoore::SearchEngine<DataType>::collect(
+   ProgressCallback on_progress, 
+   std::atomic<bool> &abort_flag
+) {
+   search(on_progress, abort_flag, false, Output::Store);
+   return std::move(result_store);
+}
+
+template <typename DataType>
+std::vector<mmoore::SearchResult<DataType>> 
+mmoore::SearchEngine<DataType>::search(
+   ProgressCallback on_progress, 
+   std::atomic<bool> &abort_flag,
+   bool generate_previews,
+   Output output
 ) {
    std::vector<mmoore::SearchResult<DataType>> results;
+   run_stats = {};
+   encoding_counts.clear();
+   result_store = {};
 
    MMOORE_LOG("config: file_path = ", config.file_path);
    MMOORE_LOG("config: is_relative_search = ", config.is_relative_search);
    MMOORE_LOG("config: endianness = ", config.endianness == mmoore::Endianness::Little ? "Little" : "Big");
    MMOORE_LOG("config: keyword (len) = ", config.keyword.size());
+   MMOORE_LOG("config: keywords (size) = ", config.keywords.size());
    MMOORE_LOG("config: custom_char_seq (len) = ", config.custom_char_seq.size());
    MMOORE_LOG("config: wildcard = ", config.wildcard);
    MMOORE_LOG("config: reference_values (size) = ", config.reference_values.size());
    MMOORE_LOG("config: preferred_num_threads = ", config.preferred_num_threads);
    MMOORE_LOG("config: preferred_search_block_size = ", config.preferred_search_block_size);
+   MMOORE_LOG("config: inline_search_size = ", config.inline_search_size);
    MMOORE_LOG("config: preferred_preview_width = ", config.preferred_preview_width);
+   MMOORE_LOG("config: instruction_set = ", mmoore::to_string(mmoore::resolve_instruction_set(config.instruction_set)));
+   MMOORE_LOG("config: pipeline = ", config.pipeline == SearchPipeline::DeltaTransform ? "DeltaTransform" : "Direct");
+   MMOORE_LOG("config: file_access = ", config.file_access == FileAccess::MemoryMapped ? "MemoryMapped" 
+      : config.file_access == FileAccess::Direct ? "Direct" : "Stream");
+   MMOORE_LOG("config: read_ahead_depth = ", config.read_ahead_depth);
 
    if (!std::filesystem::exists(config.file_path)) {
       throw std::runtime_error("File not found");
@@ -48,9 +103,59 @@ mmoore::SearchEngine<DataType>::run(
 
    uint64_t file_size = std::filesystem::file_size(config.file_path);
 
+   // workers scan the mapping in place, or read their blocks with a stream when it's not available
+   std::unique_ptr<MappedFile> mapped_file;
+
+   if (config.file_access == FileAccess::MemoryMapped) {
+      mapped_file = std::make_unique<MappedFile>(config.file_path);
+
+      if (mapped_file->is_mapped()) {
+         mapped_file->advise_sequential();
+         file_size = mapped_file->size();
+      }
+      else {
+         MMOORE_LOG("Memory mapping unavailable, falling back to stream reads");
+         mapped_file.reset();
+      }
+   }
+
    std::unique_ptr<MonkeyMoore<DataType>> searcher;
+   std::unique_ptr<MultiMonkeyMoore<DataType>> multi_searcher;
 
-   if (config.is_relative_search) {
+   // searchers sharing the difference stream of each block, indexed by keyword id
+   std::vector<MonkeyMoore<DataType>> delta_searchers;
+
+   if (config.pipeline == SearchPipeline::DeltaTransform) {
+      if (is_multi_keyword_search()) {
+         delta_searchers.reserve(config.keywords.size());
+
+         for (const auto &keyword : config.keywords) {
+            delta_searchers.emplace_back(keyword, config.wildcard, config.custom_char_seq);
+         }
+      }
+      else if (config.is_relative_search) {
+         delta_searchers.emplace_back(config.keyword, config.wildcard, config.custom_char_seq);
+      }
+      else {
+         delta_searchers.emplace_back(config.reference_values);
+      }
+
+      for (auto &delta_searcher : delta_searchers) {
+         delta_searcher.set_instruction_set(config.instruction_set);
+         delta_searcher.set_byte_order(config.endianness);
+      }
+   }
+   else if (is_multi_keyword_search()) {
+      multi_searcher = std::make_unique<MultiMonkeyMoore<DataType>>(
+         config.keywords,
+         config.wildcard,
+         config.custom_char_seq
+      );
+
+      multi_searcher->set_instruction_set(config.instruction_set);
+      multi_searcher->set_byte_order(config.endianness);
+   }
+   else if (config.is_relative_search) {
       searcher = std::make_unique<MonkeyMoore<DataType>>(
          config.keyword,
          config.wildcard,
@@ -61,153 +166,432 @@ mmoore::SearchEngine<DataType>::run(
       searcher = std::make_unique<MonkeyMoore<DataType>>(config.reference_values);
    }
 
-   auto blocks = compute_search_blocks(file_size);
+   if (searcher) {
+      searcher->set_instruction_set(config.instruction_set);
+      searcher->set_byte_order(config.endianness);
+   }
 
-   using ResultVector = std::vector<mmoore::SearchResult<DataType>>;
-   std::vector<std::future<ResultVector>> active_futures;
+   // sparse files are only scanned around their data, holes are skipped
+   const auto data_extents = config.skip_holes
+      ? find_data_extents(config.file_path, file_size)
+      : std::vector<FileExtent>{ { 0, file_size } };
 
-   std::mutex progress_mutex;
+   uint64_t data_bytes = 0;
+
+   for (const auto &extent : data_extents) {
+      data_bytes += extent.length;
+   }
 
-   int max_threads = (config.preferred_num_threads > 0) 
-      ? config.preferred_num_threads 
-      : std::thread::hardware_concurrency();
+   tune(data_bytes);
 
-   float total_progress = 0.0f;
-   const float progress_increment = 100.0f / blocks.size();
+   auto blocks = compute_search_blocks(file_size, data_extents);
 
-   auto next_block = blocks.begin();
+   uint64_t bytes_planned = 0;
 
-   on_progress(0, mmoore::SearchStep::Searching);
+   for (const auto &block : blocks) {
+      bytes_planned += std::min(block.size, block_size);
+   }
+
+   MMOORE_LOG("Skipping ", file_size - bytes_planned, " bytes of holes");
+
+   using ResultVector = std::vector<Match>;
+
+   // what each worker accumulates, only the matches themselves need merging and sorting
+   struct WorkerOutput {
+      ResultVector matches;
+      uint64_t match_count = 0;
+
+      // by MatchEncoding::key
+      std::unordered_map<uint32_t, uint64_t> encoding_counts;
+   };
+
+   std::mutex progress_mutex;
+
+   // progress is derived from a block count, as fractional increments stop adding up on
+   // files with millions of blocks
+   uint64_t blocks_done = 0;
+
+   auto scan_block = [&](
+      const SearchBlock &current_block, 
+      const uint8_t *block_data, 
+      WorkerOutput &local_output,
+      std::vector<uint8_t> &delta_buffer
+   ) {
+      MMOORE_LOG("Scanning block [offset=", current_block.offset, ", size=", current_block.size, "]");
+
+      // every alignment is searched in place over the block, which stays in cache between
+      // them (the searchers read values with unaligned, and byteswapping, loads, see
+      // load_ordered, so data_ptr is never dereferenced directly)
+      for (
+         uint32_t alignment_padding = 0; 
+         alignment_padding < sizeof(DataType) && alignment_padding < current_block.size; 
+         ++alignment_padding
+      ) {
+         const DataType *data_ptr = reinterpret_cast<const DataType *>(block_data + alignment_padding);
+         const size_t data_count = (current_block.size - alignment_padding) / sizeof(DataType);
+
+         auto add_result = [&](uint64_t match_position, const auto &encoding, uint32_t keyword_id) {
+            uint64_t block_relative_offset = (match_position * sizeof(DataType)) + alignment_padding;
+
+            // matches starting in the overlap are reported by the next block (keywords
+            // shorter than the longest one fit entirely inside it)
+            if (block_relative_offset >= block_size) {
+               return;
+            }
+
+            auto offset = current_block.offset + block_relative_offset;
 
-   while (next_block != blocks.end() || !active_futures.empty()) {
-      for (auto it = active_futures.begin(); it != active_futures.end(); ) {
-         if (it->wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-            ResultVector local_results = it->get();
+            MMOORE_LOG("Match found at offset ", offset, " (keyword ", keyword_id, ")");
+            local_output.match_count += 1;
 
-            MMOORE_LOG("Worker finished - found ", local_results.size(), " matches");
+            if (output == Output::Results || output == Output::Store) {
+               local_output.matches.push_back({ offset, encoding, keyword_id });
+            }
+            else if (output == Output::EncodingCounts) {
+               local_output.encoding_counts[encoding.key()] += 1;
+            }
+         };
 
-            if (!local_results.empty()) {
-               results.insert(
-                  results.end(),
-                  std::move_iterator(local_results.begin()),
-                  std::move_iterator(local_results.end())
-               );
+         // the searchers hand their matches straight to the worker's results
+         if (!delta_searchers.empty()) {
+            MonkeyMoore<DataType>::compute_delta_stream(data_ptr, data_count, delta_buffer, config.endianness);
+
+            for (uint32_t keyword_id = 0; keyword_id < delta_searchers.size(); ++keyword_id) {
+               delta_searchers[keyword_id].search_delta_stream(
+                  data_ptr, 
+                  delta_buffer.data(), 
+                  data_count,
+                  [&](const auto &match) { add_result(match.offset, match.encoding, keyword_id); });
             }
-            
-            it = active_futures.erase(it);
+         }
+         else if (multi_searcher) {
+            multi_searcher->search(data_ptr, data_count, [&](const auto &match) {
+               add_result(match.offset, match.encoding, match.keyword_id);
+            });
          }
          else {
-            ++it;
+            searcher->search(data_ptr, data_count, [&](const auto &match) {
+               add_result(match.offset, match.encoding, 0);
+            });
          }
       }
+   };
 
-      if (next_block != blocks.end() && active_futures.size() < max_threads) {
-         SearchBlock current_block = *next_block;
-
-         auto worker = [
-            this, 
-            current_block, 
-            &progress_mutex, 
-            &total_progress, 
-            progress_increment,
-            &on_progress,
-            &searcher
-         ]() -> ResultVector {   
-            ResultVector local_results;
-
-            MMOORE_LOG("Worker spawned for block [offset=", current_block.offset, ", size=", current_block.size, "]");
-
-            std::ifstream file(config.file_path, std::ios::binary);
-            if (!file.is_open()) {
-               throw std::runtime_error("Worker thread failed to open file: " + config.file_path.string());
-            }
+   on_progress(0, mmoore::SearchStep::Searching);
 
-            std::vector<uint8_t> raw_buffer(current_block.size);
-            file.seekg(current_block.offset);
-            file.read(reinterpret_cast<char *>(raw_buffer.data()), current_block.size);
+   // workers pull blocks in file order from a shared counter, so a slow block never holds
+   // back the others and no thread sits idle while there's work left
+   std::atomic<size_t> next_block{0};
 
-            for (
-               uint32_t alignment_padding = 0; 
-               alignment_padding < sizeof(DataType); 
-               ++alignment_padding
-            ) {
-               std::vector<uint8_t> work_buffer = raw_buffer;
+   const size_t num_workers = std::max<size_t>(std::min(num_threads, blocks.size()), 1);
+   std::vector<WorkerOutput> worker_outputs(num_workers);
 
-               DataType *data_ptr = reinterpret_cast<DataType *>(work_buffer.data() + alignment_padding);
-               size_t data_count = static_cast<size_t>(floor(double(current_block.size) / sizeof(DataType)));
+   std::atomic<uint64_t> buffer_allocations{0};
+   std::atomic<uint64_t> buffer_bytes_allocated{0};
 
-               if (reinterpret_cast<uint8_t *>(data_ptr + data_count) > work_buffer.data() + current_block.size) {
-                  data_count -= 1;
-               }
+   auto count_allocation = [&](size_t bytes) {
+      buffer_allocations += 1;
+      buffer_bytes_allocated += bytes;
+   };
 
-               if (sizeof(DataType) > 1) {
-                  mmoore::adjust_endianness(data_ptr, data_count, config.endianness);
-               }
+   std::atomic<int64_t> io_wait_ns{0};
+   std::atomic<int64_t> compute_ns{0};
+   std::atomic<ReadAheadBackend> read_ahead_backend{ReadAheadBackend::None};
+   std::atomic<bool> direct_io{false};
 
-               auto matches = searcher->search(data_ptr, data_count);
+   auto scan_and_report = [&](
+      const SearchBlock &current_block, 
+      const uint8_t *block_data, 
+      WorkerOutput &local_output,
+      std::vector<uint8_t> &delta_buffer
+   ) {
+      const size_t delta_capacity = delta_buffer.capacity();
+      const auto scan_start = std::chrono::steady_clock::now();
 
-               local_results.reserve(matches.size());
-               for (const auto &[match_position, values_map] : matches) {
-                  auto offset = 
-                     current_block.offset 
-                     + (match_position * sizeof(DataType)) 
-                     + alignment_padding;
+      scan_block(current_block, block_data, local_output, delta_buffer);
 
-                  MMOORE_LOG("Match found at offset ", offset);
-                  local_results.push_back({ offset, values_map });
-               }
+      compute_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+         std::chrono::steady_clock::now() - scan_start).count();
+
+      if (delta_buffer.capacity() != delta_capacity) {
+         count_allocation(delta_buffer.capacity());
+      }
+
+      std::lock_guard<std::mutex> lock(progress_mutex);
+      blocks_done += 1;
+      on_progress(static_cast<int>(blocks_done * 100 / blocks.size()), SearchStep::Searching);
+   };
+
+   auto search_worker = [&](size_t worker_index) {
+      WorkerOutput &local_output = worker_outputs[worker_index];
+
+      // reused for every block of this worker, so only the first one allocates
+      std::vector<uint8_t> delta_buffer;
+
+      if (mapped_file) {
+         for (size_t i = next_block++; i < blocks.size() && !abort_flag; i = next_block++) {
+            // the next block is paged in while this one is scanned
+            if (i + 1 < blocks.size()) {
+               mapped_file->advise_will_need(blocks[i + 1].offset, blocks[i + 1].size);
             }
 
-            {
-               std::lock_guard<std::mutex> lock(progress_mutex);
-               total_progress += progress_increment;
-               on_progress(static_cast<int>(total_progress), SearchStep::Searching);
+            scan_and_report(blocks[i], mapped_file->data() + blocks[i].offset, local_output, delta_buffer);
+         }
+      }
+      else {
+         // the worker claims blocks as read-ahead slots free up, so up to read_ahead_depth
+         // of them are being read while it scans (a single block is just read, there's
+         // nothing to overlap it with)
+         const size_t read_ahead_depth = blocks.size() > 1 
+            ? static_cast<size_t>(std::max(config.read_ahead_depth, 0)) 
+            : 0;
+
+         ReadAheadQueue read_ahead(
+            config.file_path,
+            read_ahead_depth,
+            config.read_ahead_backend,
+            config.huge_page_buffers,
+            config.file_access == FileAccess::Direct);
+
+         read_ahead_backend = read_ahead.backend();
+         direct_io = read_ahead.is_direct();
+
+         auto claim_blocks = [&]() {
+            while (read_ahead.can_submit() && !abort_flag) {
+               size_t i = next_block++;
+
+               if (i >= blocks.size()) {
+                  break;
+               }
+
+               read_ahead.submit(blocks[i].offset, blocks[i].size, i);
             }
-            
-            return local_results;
          };
 
-         active_futures.push_back(std::async(std::launch::async, worker));
-         ++next_block;
+         claim_blocks();
+
+         while (!read_ahead.empty() && !abort_flag) {
+            auto block = read_ahead.next();
+
+            // reads into the free slots run while this block is scanned
+            claim_blocks();
+
+            // the file may have shrunk since it was measured
+            SearchBlock current_block = blocks[block.tag];
+            current_block.size = block.size;
+
+            scan_and_report(current_block, block.data, local_output, delta_buffer);
+
+            read_ahead.release();
+            claim_blocks();
+         }
+
+         buffer_allocations += read_ahead.buffer_allocations();
+         buffer_bytes_allocated += read_ahead.buffer_bytes_allocated();
+         io_wait_ns += read_ahead.io_wait_time().count();
+      }
+
+      MMOORE_LOG("Worker ", worker_index, " finished - found ", local_output.match_count, " matches");
+   };
+
+   // a lone worker (small files) runs on the calling thread, waking no pool thread up
+   if (num_workers == 1) {
+      search_worker(0);
+   }
+   else {
+      ThreadPool::shared().run(num_workers, search_worker);
+   }
+
+   run_stats.buffer_allocations = buffer_allocations;
+   run_stats.buffer_bytes_allocated = buffer_bytes_allocated;
+   run_stats.peak_rss_bytes = peak_resident_set_size();
+   run_stats.io_wait_time = std::chrono::nanoseconds(io_wait_ns.load());
+   run_stats.compute_time = std::chrono::nanoseconds(compute_ns.load());
+   run_stats.read_ahead_backend = read_ahead_backend;
+   run_stats.direct_io = direct_io;
+   run_stats.bytes_skipped = file_size - bytes_planned;
+   run_stats.block_size = block_size;
+   run_stats.num_blocks = blocks.size();
+   run_stats.num_threads = num_workers;
+
+   MMOORE_LOG("Buffers: ", run_stats.buffer_allocations, " allocations, ", run_stats.buffer_bytes_allocated, " bytes");
+   MMOORE_LOG("Workers: ", io_wait_ns.load(), " ns waiting for I/O, ", compute_ns.load(), " ns scanning");
+
+   if (abort_flag) {
+      MMOORE_LOG("Search aborted");
+      return {};
+   }
+
+   for (const auto &local_output : worker_outputs) {
+      run_stats.matches += local_output.match_count;
+   }
+
+   MMOORE_LOG("Search completed - ", run_stats.matches, " results found");
+
+   // the map of each encoding is built once and shared by its results
+   using EquivalencyMap = typename MonkeyMoore<DataType>::equivalency_map;
+   std::unordered_map<uint32_t, std::shared_ptr<const EquivalencyMap>> interned_maps;
+
+   auto make_equivalency_map = [&](const typename MonkeyMoore<DataType>::encoding_type &encoding) {
+      if (!delta_searchers.empty()) {
+         return delta_searchers.front().make_equivalency_map(encoding);
       }
-      else if (active_futures.size() >= max_threads) {
-         std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+      return multi_searcher 
+         ? multi_searcher->make_equivalency_map(encoding) 
+         : searcher->make_equivalency_map(encoding);
+   };
+
+   auto intern_equivalency_map = [&](const typename MonkeyMoore<DataType>::encoding_type &encoding) {
+      auto &values_map = interned_maps[encoding.key()];
+
+      if (!values_map) {
+         values_map = std::make_shared<const EquivalencyMap>(make_equivalency_map(encoding));
       }
 
-      if (abort_flag) {
-         MMOORE_LOG("Search aborted - waiting for ", active_futures.size(), " active threads");
+      return values_map;
+   };
 
-         for (auto &f : active_futures) {
-            if (f.valid()) {
-               f.wait();
-            }
+   if (output == Output::Count) {
+      return {};
+   }
+
+   if (output == Output::EncodingCounts) {
+      std::unordered_map<uint32_t, uint64_t> totals;
+
+      for (const auto &local_output : worker_outputs) {
+         for (const auto &[key, count] : local_output.encoding_counts) {
+            totals[key] += count;
          }
+      }
+
+      for (const auto &[key, count] : totals) {
+         typename MonkeyMoore<DataType>::encoding_type encoding;
+         encoding.base = static_cast<DataType>(key & 0xFFFF);
+         encoding.upper_base = static_cast<DataType>(key >> 16);
 
-         return {};
+         encoding_counts.push_back({ encoding, intern_equivalency_map(encoding), count });
       }
+
+      std::sort(encoding_counts.begin(), encoding_counts.end(), 
+         [](const EncodingCount<DataType> &a, const EncodingCount<DataType> &b) {
+            return a.count != b.count ? a.count > b.count : a.encoding.key() < b.encoding.key();
+         }
+      );
+
+      MMOORE_LOG("Encodings: ", encoding_counts.size(), " distinct");
+      return {};
+   }
+
+   ResultVector matches;
+   matches.reserve(run_stats.matches);
+
+   for (auto &local_output : worker_outputs) {
+      matches.insert(matches.end(), local_output.matches.begin(), local_output.matches.end());
    }
 
-   MMOORE_LOG("Search completed - ", results.size(), " results found");
    on_progress(100, GeneratingPreviews);
 
-   std::sort(results.begin(), results.end(), 
-      [](mmoore::SearchResult<DataType> &a, mmoore::SearchResult<DataType> &b) {
-         return a.offset < b.offset;
+   std::sort(matches.begin(), matches.end(), 
+      [](const Match &a, const Match &b) {
+         return a.offset != b.offset ? a.offset < b.offset : a.keyword_id < b.keyword_id;
       }
    );
 
+   if (output == Output::Store) {
+      // encoding ids follow the order in which the encodings first appear in the file
+      std::unordered_map<uint32_t, uint32_t> encoding_ids;
+
+      result_store.offset_column.reserve(matches.size());
+      result_store.encoding_id_column.reserve(matches.size());
+
+      if (is_multi_keyword_search()) {
+         result_store.keyword_id_column.reserve(matches.size());
+      }
+
+      for (const auto &match : matches) {
+         auto [it, inserted] = encoding_ids.try_emplace(
+            match.encoding.key(), 
+            static_cast<uint32_t>(result_store.encoding_table.size()));
+
+         if (inserted) {
+            result_store.encoding_table.push_back(match.encoding);
+            result_store.map_table.push_back(intern_equivalency_map(match.encoding));
+         }
+
+         result_store.offset_column.push_back(match.offset);
+         result_store.encoding_id_column.push_back(it->second);
+
+         if (is_multi_keyword_search()) {
+            result_store.keyword_id_column.push_back(match.keyword_id);
+         }
+      }
+
+      // previews are read with a copy of the engine and a stream of its own, opened by the
+      // first one, so the store doesn't depend on this engine or its mapping
+      auto preview_engine = std::make_shared<SearchEngine<DataType>>(config);
+      auto preview_file = std::make_shared<std::ifstream>();
+
+      result_store.preview_source = [preview_engine, preview_file, file_size](
+         uint64_t offset, 
+         uint32_t keyword_id, 
+         const EquivalencyMap &values_map
+      ) {
+         if (!preview_file->is_open()) {
+            preview_file->open(preview_engine->config.file_path, std::ios::binary);
+
+            if (!preview_file->is_open()) {
+               throw std::runtime_error("Failed to open file to generate previews: " + preview_engine->config.file_path.string());
+            }
+         }
+
+         size_t keyword_len = preview_engine->is_multi_keyword_search()
+            ? preview_engine->config.keywords[keyword_id].size()
+            : preview_engine->config.keyword.size();
+
+         return preview_engine->generate_preview(nullptr, *preview_file, file_size, offset, keyword_len, values_map);
+      };
+
+      MMOORE_LOG("Result store: ", result_store.size(), " results, ", result_store.num_encodings(), 
+         " distinct encodings, ", result_store.memory_usage(), " bytes");
+      return {};
+   }
+
+   results.reserve(matches.size());
+
+   for (const auto &match : matches) {
+      results.push_back({ match.offset, intern_equivalency_map(match.encoding), "", match.keyword_id });
+   }
+
+   MMOORE_LOG("Equivalency maps: ", interned_maps.size(), " distinct encodings");
+
    if (generate_previews && !results.empty()) {
       MMOORE_LOG("Starting preview generation for ", results.size(), " results");
 
-      std::ifstream preview_file(config.file_path, std::ios::binary);
-      if (!preview_file.is_open()) {
-         throw std::runtime_error("Failed to open file to generate previews: " + config.file_path.string());
+      std::ifstream preview_file;
+
+      if (!mapped_file) {
+         preview_file.open(config.file_path, std::ios::binary);
+
+         if (!preview_file.is_open()) {
+            throw std::runtime_error("Failed to open file to generate previews: " + config.file_path.string());
+         }
       }
 
       std::for_each(results.begin(), results.end(), 
-         [this, &preview_file, file_size](mmoore::SearchResult<DataType> &result) {
+         [this, &mapped_file, &preview_file, file_size](mmoore::SearchResult<DataType> &result) {
             MMOORE_LOG("Generating preview for result at offset ", result.offset);
-            result.preview = generate_preview(preview_file, file_size, result.offset, result.values_map);
+            size_t keyword_len = is_multi_keyword_search()
+               ? config.keywords[result.keyword_id].size()
+               : config.keyword.size();
+
+            result.preview = generate_preview(
+               mapped_file.get(), 
+               preview_file, 
+               file_size, 
+               result.offset, 
+               keyword_len, 
+               *result.values_map);
          }
       );
    }
@@ -217,50 +601,152 @@ mmoore::SearchEngine<DataType>::run(
 
 template<typename DataType>
 std::vector<typename mmoore::SearchEngine<DataType>::SearchBlock> 
-mmoore::SearchEngine<DataType>::compute_search_blocks(uint64_t file_size) {
+mmoore::SearchEngine<DataType>::compute_search_blocks(
+   uint64_t file_size, 
+   const std::vector<FileExtent> &data_extents
+) {
    std::vector<SearchBlock> blocks;
 
-   size_t pattern_len =  config.is_relative_search
-      ? config.keyword.size()
-      : config.reference_values.size();
+   // blocks must overlap enough to fit the longest keyword across their boundaries. Wider
+   // values can start on any byte, up to the block's last one, so the overlap holds the
+   // whole keyword but that byte
+   const size_t pattern_len = longest_pattern_length();
+   const uint64_t overlap_size = pattern_len > 0 ? pattern_len * sizeof(DataType) - 1 : 0;
 
-   const uint32_t overlap_size = (pattern_len - 1) * sizeof(DataType);
+   const uint64_t base_size = block_size;
+   const uint64_t full_block_size = base_size + overlap_size;
 
-   const uint32_t block_base_size = config.preferred_search_block_size;
-   const uint32_t full_block_size = block_base_size + overlap_size;
+   // a hole reads as zeros, so windows reaching into one from a data extent are scanned by
+   // growing every extent by a window on both sides. Extents this close (or closer) are
+   // scanned as one, so fragmented files don't turn into swarms of tiny blocks
+   const uint64_t window_size = pattern_len * sizeof(DataType);
+   constexpr uint64_t hole_merge_gap = 64 << 10;
 
-   uint32_t num_blocks = static_cast<uint32_t>(
-      std::ceil(static_cast<double>(file_size) / block_base_size)
-   );
+   std::vector<FileExtent> regions;
+
+   for (const auto &extent : data_extents) {
+      const uint64_t start = extent.offset - std::min(extent.offset, window_size);
+      const uint64_t end = std::min(file_size, extent.offset + extent.length + window_size);
+
+      if (!regions.empty() && start <= regions.back().offset + regions.back().length + hole_merge_gap) {
+         regions.back().length = std::max(regions.back().length, end - regions.back().offset);
+      }
+      else {
+         regions.push_back({ start, end - start });
+      }
+   }
 
    MMOORE_LOG("compute_search_blocks: overlap_size = ", overlap_size);
-   MMOORE_LOG("compute_search_blocks: block_base_size = " , block_base_size);
+   MMOORE_LOG("compute_search_blocks: block_base_size = " , base_size);
    MMOORE_LOG("compute_search_blocks: full_block_size = ", full_block_size);
-   MMOORE_LOG("compute_search_blocks: num_blocks: ", num_blocks);
+   MMOORE_LOG("compute_search_blocks: regions: ", regions.size());
 
-   for (uint32_t i = 0; i < num_blocks; ++i) {
-      uint64_t offset = i * block_base_size;
+   // all of the planning is done in 64 bits, so offsets past 4 GB don't wrap around. Blocks
+   // never outgrow base_size + overlap_size, so a block reports the matches starting in its
+   // first base_size bytes and leaves the rest to the next block of the region (if any)
+   for (const auto &region : regions) {
+      const uint64_t region_end = region.offset + region.length;
 
-      uint64_t remaining = file_size - offset;
-      uint32_t size = static_cast<uint32_t>(
-         std::min(static_cast<uint64_t>(full_block_size), remaining)
-      );
+      for (uint64_t offset = region.offset; offset < region_end; offset += base_size) {
+         blocks.push_back({ offset, std::min(full_block_size, region_end - offset) });
 
-      blocks.push_back({ offset, size });
+         if (region_end - offset <= base_size) {
+            break;
+         }
+      }
    }
 
+   MMOORE_LOG("compute_search_blocks: num_blocks: ", blocks.size());
+
    return blocks;
 }
 
+template<typename DataType>
+void mmoore::SearchEngine<DataType>::tune(uint64_t data_bytes) {
+   const auto &topology = detect_cpu_topology();
+
+   // scanning a small file takes less than handing it to other threads would
+   const bool is_small = data_bytes <= config.inline_search_size;
+
+   // hyperthreads share the core's execution units and caches, so they add little to a scan
+   if (config.preferred_num_threads > 0) {
+      num_threads = static_cast<size_t>(config.preferred_num_threads);
+   }
+   else {
+      num_threads = is_small ? 1 : topology.physical_cores;
+   }
+
+   if (config.preferred_search_block_size > 0) {
+      block_size = config.preferred_search_block_size;
+   }
+   else if (is_small && num_threads == 1) {
+      // a single block, read (or paged in) at once
+      block_size = data_bytes;
+   }
+   else {
+      // the block should stay in the L2 cache while every alignment is scanned, next to the
+      // searcher's tables (and the difference stream, which is as large as the block), and
+      // the workers' blocks should fit in the L3 together
+      const uint64_t cache_share = config.pipeline == SearchPipeline::DeltaTransform ? 4 : 2;
+      uint64_t cache_budget = default_auto_block_size;
+
+      if (topology.l2_cache_size > 0) {
+         cache_budget = topology.l2_cache_size / cache_share;
+      }
+
+      if (topology.l3_cache_size > 0) {
+         cache_budget = std::min<uint64_t>(cache_budget, topology.l3_cache_size / (cache_share * num_threads));
+      }
+
+      block_size = std::clamp(cache_budget, min_auto_block_size, max_auto_block_size);
+
+      // keep whole pages
+      block_size -= block_size % min_auto_block_size;
+
+      // smaller files are split further, so every worker gets several blocks and the ones
+      // finishing early can pick up the slack
+      const uint64_t balanced_size = data_bytes / (num_threads * blocks_per_worker);
+      const uint64_t min_size = std::max<uint64_t>(min_auto_block_size, 8 * longest_pattern_length() * sizeof(DataType));
+
+      block_size = std::max(std::min(block_size, balanced_size), min_size);
+   }
+
+   // blocks (and their buffers) must be addressable on 32-bit platforms as well
+   constexpr uint64_t max_block_size = std::numeric_limits<size_t>::max() / 2;
+   block_size = std::clamp<uint64_t>(block_size, 1, max_block_size);
+
+   MMOORE_LOG("tune: ", data_bytes, " bytes of data -> ", num_threads, " threads, ", block_size, " bytes per block");
+}
+
+template<typename DataType>
+size_t mmoore::SearchEngine<DataType>::longest_pattern_length() const {
+   if (is_multi_keyword_search()) {
+      size_t pattern_len = 0;
+
+      for (const auto &keyword : config.keywords) {
+         pattern_len = std::max(pattern_len, keyword.size());
+      }
+
+      return pattern_len;
+   }
+
+   return config.is_relative_search ? config.keyword.size() : config.reference_values.size();
+}
+
+template<typename DataType>
+bool mmoore::SearchEngine<DataType>::is_multi_keyword_search() const {
+   return config.is_relative_search && !config.keywords.empty();
+}
 
 template<typename DataType>
 std::string mmoore::SearchEngine<DataType>::generate_preview(
+   const MappedFile *mapped_file,
    std::ifstream &file, 
    uint64_t file_size,
    uint64_t match_offset, 
-   std::map<CharType, DataType> &values_map
+   size_t keyword_len,
+   const std::map<CharType, DataType> &values_map
 ) {
-   const size_t keyword_len = config.keyword.size();
    const int preview_window_width = config.preferred_preview_width;
    
    // places current match in the center of the preview
@@ -281,14 +767,27 @@ std::string mmoore::SearchEngine<DataType>::generate_preview(
       start_offset -= end_offset - file_size;
    }
 
-   file.seekg(std::max(static_cast<int64_t>(0), start_offset), std::ios::beg);
+   const uint64_t read_offset = static_cast<uint64_t>(std::max(static_cast<int64_t>(0), start_offset));
 
    std::vector<DataType> buffer(preview_window_width);
-   file.read(reinterpret_cast<char *>(buffer.data()), preview_window_width * sizeof(DataType));
+   size_t bytes_read = 0;
+
+   if (mapped_file) {
+      bytes_read = static_cast<size_t>(std::min<uint64_t>(
+         preview_window_width * sizeof(DataType), 
+         file_size - std::min(read_offset, file_size)));
+
+      std::memcpy(buffer.data(), mapped_file->data() + read_offset, bytes_read);
+   }
+   else {
+      file.seekg(read_offset, std::ios::beg);
+      file.read(reinterpret_cast<char *>(buffer.data()), preview_window_width * sizeof(DataType));
+
+      //TODO: remove?
+      // handle end of file
+      bytes_read = file.gcount();
+   }
 
-   //TODO: remove?
-   // handle end of file
-   size_t bytes_read = file.gcount();
    size_t items_read = bytes_read / sizeof(DataType);
    buffer.resize(items_read);
 
@@ -301,7 +800,7 @@ std::string mmoore::SearchEngine<DataType>::generate_preview(
 
 template<typename DataType>
 std::string mmoore::SearchEngine<DataType>::decode_raw_data(
-   std::map<CharType, DataType> &values_map, 
+   const std::map<CharType, DataType> &values_map, 
    std::vector<DataType> &raw_data
 ) {
    const bool is_ascii_search = config.custom_char_seq.empty();
@@ -0,0 +1,427 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef MONKEY_CORE_SIMD_KERNELS_HPP
+#define MONKEY_CORE_SIMD_KERNELS_HPP
+
+#include "mmoore/cpu_dispatch.hpp"
+#include "mmoore/byteswap.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+   #define MMOORE_HAS_X86_KERNELS 1
+   #include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+   #include <intrin.h>
+   // MSVC exposes every intrinsic regardless of the target flags
+   #define MMOORE_TARGET(isa)
+#else
+   // each tier is compiled for its own ISA and only called after a cpuid check
+   #define MMOORE_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace mmoore {
+   namespace simd {
+
+      /**
+       * Pair of keyword positions whose relative difference is tested by the candidate
+       * filters. Wildcard keywords probe bridged positions, so they aren't always adjacent.
+       */
+      struct DiffProbe {
+         long current;
+         long previous;
+      };
+
+      /**
+       * The two probes a candidate window must satisfy, along with their expected
+       * (wrapping) relative differences.
+       */
+      template <class Ty>
+      struct ProbePair {
+         DiffProbe first;
+         Ty first_expected;
+         DiffProbe second;
+         Ty second_expected;
+      };
+
+      // Capacity of the buffer the scanners fill with candidate window starts
+      constexpr size_t candidate_buffer_size = 512;
+
+      /**
+       * Scans window starts beginning at 'position' (up to and including 'last_start') and
+       * appends those passing both probes to 'candidates', in increasing order. It stops
+       * early when the buffer can't hold another batch. Scanners are instantiated per byte order
+       * of the data, so foreign-order values are swapped in registers right after each load.
+       * @return The next window start that wasn't scanned yet
+       */
+      template <class Ty>
+      using CandidateScanner = uint64_t (*)(
+         const Ty *data,
+         uint64_t position,
+         uint64_t last_start,
+         const ProbePair<Ty> &probes,
+         uint64_t *candidates,
+         size_t &count
+      );
+
+      /**
+       * Returns the index of the lowest set bit of a non-zero mask.
+       */
+      inline int lowest_bit_index(uint64_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+         unsigned long index;
+         _BitScanForward64(&index, mask);
+         return static_cast<int>(index);
+#else
+         return __builtin_ctzll(mask);
+#endif
+      }
+
+      inline void append_candidates(uint64_t batch_start, uint64_t mask, uint64_t *candidates, size_t &count) {
+         while (mask != 0) {
+            candidates[count++] = batch_start + lowest_bit_index(mask);
+            mask &= mask - 1;
+         }
+      }
+
+      template <class Ty, Endianness Order>
+      inline bool probe_matches(const Ty *window, const DiffProbe &probe, Ty expected) {
+         return static_cast<Ty>(
+            load_ordered<Order>(window + probe.current) - load_ordered<Order>(window + probe.previous)) == expected;
+      }
+
+      /**
+       * Scalar fallback used for the window starts that don't fill a whole batch.
+       */
+      template <class Ty, Endianness Order>
+      inline uint64_t scan_candidates_scalar(
+         const Ty *data,
+         uint64_t position,
+         uint64_t last_start,
+         const ProbePair<Ty> &probes,
+         uint64_t *candidates,
+         size_t &count
+      ) {
+         for (; position <= last_start && count < candidate_buffer_size; ++position) {
+            if (probe_matches<Ty, Order>(data + position, probes.first, probes.first_expected) &&
+                probe_matches<Ty, Order>(data + position, probes.second, probes.second_expected)) {
+               candidates[count++] = position;
+            }
+         }
+
+         return position;
+      }
+
+#if defined(MMOORE_HAS_X86_KERNELS)
+
+      // SSE2 (baseline x86-64) and SSE4.2 tiers, 16 bytes per batch
+
+      template <class Ty>
+      MMOORE_TARGET("sse2")
+      inline __m128i broadcast_sse2(Ty value) {
+         if constexpr (sizeof(Ty) == 1) {
+            return _mm_set1_epi8(static_cast<char>(value));
+         }
+         else {
+            return _mm_set1_epi16(static_cast<short>(value));
+         }
+      }
+
+      /**
+       * Loads 16 bytes, swapping the bytes of each 16-bit lane when the data isn't in the system's
+       * byte order (SSE2 has no byte shuffle, so the halves are swapped with shifts).
+       */
+      template <class Ty, Endianness Order>
+      MMOORE_TARGET("sse2")
+      inline __m128i load_ordered_sse2(const Ty *source) {
+         __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source));
+
+         if constexpr (sizeof(Ty) > 1 && Order != system_endianness) {
+            values = _mm_or_si128(_mm_slli_epi16(values, 8), _mm_srli_epi16(values, 8));
+         }
+
+         return values;
+      }
+
+      template <class Ty, Endianness Order>
+      MMOORE_TARGET("sse2")
+      inline __m128i diff_equals_sse2(const Ty *current_at, const Ty *previous_at, __m128i expected) {
+         __m128i current = load_ordered_sse2<Ty, Order>(current_at);
+         __m128i previous = load_ordered_sse2<Ty, Order>(previous_at);
+
+         if constexpr (sizeof(Ty) == 1) {
+            return _mm_cmpeq_epi8(_mm_sub_epi8(current, previous), expected);
+         }
+         else {
+            return _mm_cmpeq_epi16(_mm_sub_epi16(current, previous), expected);
+         }
+      }
+
+      /**
+       * Narrows a lane-wise compare result so that bit j refers to the j-th element.
+       */
+      template <class Ty>
+      MMOORE_TARGET("sse2")
+      inline uint64_t lane_mask_sse2(__m128i hits) {
+         if constexpr (sizeof(Ty) == 1) {
+            return static_cast<uint32_t>(_mm_movemask_epi8(hits));
+         }
+         else {
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(hits, _mm_setzero_si128())));
+         }
+      }
+
+      template <class Ty, Endianness Order>
+      MMOORE_TARGET("sse2")
+      uint64_t scan_candidates_sse2(
+         const Ty *data,
+         uint64_t position,
+         uint64_t last_start,
+         const ProbePair<Ty> &probes,
+         uint64_t *candidates,
+         size_t &count
+      ) {
+         constexpr uint64_t lanes = 16 / sizeof(Ty);
+         const __m128i first_diff = broadcast_sse2(probes.first_expected);
+         const __m128i second_diff = broadcast_sse2(probes.second_expected);
+
+         // probes never reach past the window, so every load of the batch stays in bounds
+         for (; position + lanes - 1 <= last_start; position += lanes) {
+            if (count + lanes > candidate_buffer_size) {
+               return position;
+            }
+
+            const Ty *batch = data + position;
+
+            __m128i hits = _mm_and_si128(
+               diff_equals_sse2<Ty, Order>(batch + probes.first.current, batch + probes.first.previous, first_diff),
+               diff_equals_sse2<Ty, Order>(batch + probes.second.current, batch + probes.second.previous, second_diff));
+
+            append_candidates(position, lane_mask_sse2<Ty>(hits), candidates, count);
+         }
+
+         return scan_candidates_scalar<Ty, Order>(data, position, last_start, probes, candidates, count);
+      }
+
+      template <class Ty, Endianness Order>
+      MMOORE_TARGET("sse4.2")
+      uint64_t scan_candidates_sse42(
+         const Ty *data,
+         uint64_t position,
+         uint64_t last_start,
+         const ProbePair<Ty> &probes,
+         uint64_t *candidates,
+         size_t &count
+      ) {
+         constexpr uint64_t lanes = 16 / sizeof(Ty);
+         const __m128i first_diff = broadcast_sse2(probes.first_expected);
+         const __m128i second_diff = broadcast_sse2(probes.second_expected);
+
+         for (; position + lanes - 1 <= last_start; position += lanes) {
+            if (count + lanes > candidate_buffer_size) {
+               return position;
+            }
+
+            const Ty *batch = data + position;
+
+            __m128i hits = _mm_and_si128(
+               diff_equals_sse2<Ty, Order>(batch + probes.first.current, batch + probes.first.previous, first_diff),
+               diff_equals_sse2<Ty, Order>(batch + probes.second.current, batch + probes.second.previous, second_diff));
+
+            // most batches have no candidates at all, so ptest lets us skip the mask extraction
+            if (!_mm_testz_si128(hits, hits)) {
+               append_candidates(position, lane_mask_sse2<Ty>(hits), candidates, count);
+            }
+         }
+
+         return scan_candidates_scalar<Ty, Order>(data, position, last_start, probes, candidates, count);
+      }
+
+      // AVX2 tier, 32 bytes per batch
+
+      template <class Ty>
+      MMOORE_TARGET("avx2")
+      inline __m256i broadcast_avx2(Ty value) {
+         if constexpr (sizeof(Ty) == 1) {
+            return _mm256_set1_epi8(static_cast<char>(value));
+         }
+         else {
+            return _mm256_set1_epi16(static_cast<short>(value));
+         }
+      }
+
+      template <class Ty, Endianness Order>
+      MMOORE_TARGET("avx2")
+      inline __m256i load_ordered_avx2(const Ty *source) {
+         __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source));
+
+         if constexpr (sizeof(Ty) > 1 && Order != system_endianness) {
+            const __m256i swap_pairs = _mm256_setr_epi8(
+               1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+               1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+
+            values = _mm256_shuffle_epi8(values, swap_pairs);
+         }
+
+         return values;
+      }
+
+      template <class Ty, Endianness Order>
+      MMOORE_TARGET("avx2")
+      inline __m256i diff_equals_avx2(const Ty *current_at, const Ty *previous_at, __m256i expected) {
+         __m256i current = load_ordered_avx2<Ty, Order>(current_at);
+         __m256i previous = load_ordered_avx2<Ty, Order>(previous_at);
+
+         if constexpr (sizeof(Ty) == 1) {
+            return _mm256_cmpeq_epi8(_mm256_sub_epi8(current, previous), expected);
+         }
+         else {
+            return _mm256_cmpeq_epi16(_mm256_sub_epi16(current, previous), expected);
+         }
+      }
+
+      template <class Ty>
+      MMOORE_TARGET("avx2")
+      inline uint64_t lane_mask_avx2(__m256i hits) {
+         if constexpr (sizeof(Ty) == 1) {
+            return static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+         }
+         else {
+            __m128i packed = _mm_packs_epi16(
+               _mm256_castsi256_si128(hits),
+               _mm256_extracti128_si256(hits, 1));
+
+            return static_cast<uint32_t>(_mm_movemask_epi8(packed));
+         }
+      }
+
+      template <class Ty, Endianness Order>
+      MMOORE_TARGET("avx2")
+      uint64_t scan_candidates_avx2(
+         const Ty *data,
+         uint64_t position,
+         uint64_t last_start,
+         const ProbePair<Ty> &probes,
+         uint64_t *candidates,
+         size_t &count
+      ) {
+         constexpr uint64_t lanes = 32 / sizeof(Ty);
+         const __m256i first_diff = broadcast_avx2(probes.first_expected);
+         const __m256i second_diff = broadcast_avx2(probes.second_expected);
+
+         for (; position + lanes - 1 <= last_start; position += lanes) {
+            if (count + lanes > candidate_buffer_size) {
+               return position;
+            }
+
+            const Ty *batch = data + position;
+
+            __m256i hits = _mm256_and_si256(
+               diff_equals_avx2<Ty, Order>(batch + probes.first.current, batch + probes.first.previous, first_diff),
+               diff_equals_avx2<Ty, Order>(batch + probes.second.current, batch + probes.second.previous, second_diff));
+
+            if (!_mm256_testz_si256(hits, hits)) {
+               append_candidates(position, lane_mask_avx2<Ty>(hits), candidates, count);
+            }
+         }
+
+         return scan_candidates_scalar<Ty, Order>(data, position, last_start, probes, candidates, count);
+      }
+
+      // AVX-512 tier, 64 bytes per batch (compares write straight into mask registers)
+
+      template <class Ty, Endianness Order>
+      MMOORE_TARGET("avx512f,avx512bw")
+      inline __m512i load_ordered_avx512(const Ty *source) {
+         __m512i values = _mm512_loadu_si512(reinterpret_cast<const void *>(source));
+
+         if constexpr (sizeof(Ty) > 1 && Order != system_endianness) {
+            // the shuffle works within 128-bit lanes, so the same pattern repeats 4 times
+            // (bytes 1, 0, 3, 2, ... 15, 14 of each lane, packed in little-endian dwords)
+            const __m512i swap_pairs = _mm512_set4_epi32(0x0E0F0C0D, 0x0A0B0809, 0x06070405, 0x02030001);
+
+            values = _mm512_shuffle_epi8(values, swap_pairs);
+         }
+
+         return values;
+      }
+
+      template <class Ty, Endianness Order>
+      MMOORE_TARGET("avx512f,avx512bw")
+      inline uint64_t diff_equals_avx512(const Ty *current_at, const Ty *previous_at, Ty expected, uint64_t lane_mask) {
+         __m512i current = load_ordered_avx512<Ty, Order>(current_at);
+         __m512i previous = load_ordered_avx512<Ty, Order>(previous_at);
+
+         if constexpr (sizeof(Ty) == 1) {
+            return _mm512_mask_cmpeq_epi8_mask(
+               static_cast<__mmask64>(lane_mask),
+               _mm512_sub_epi8(current, previous),
+               _mm512_set1_epi8(static_cast<char>(expected)));
+         }
+         else {
+            return _mm512_mask_cmpeq_epi16_mask(
+               static_cast<__mmask32>(lane_mask),
+               _mm512_sub_epi16(current, previous),
+               _mm512_set1_epi16(static_cast<short>(expected)));
+         }
+      }
+
+      template <class Ty, Endianness Order>
+      MMOORE_TARGET("avx512f,avx512bw")
+      uint64_t scan_candidates_avx512(
+         const Ty *data,
+         uint64_t position,
+         uint64_t last_start,
+         const ProbePair<Ty> &probes,
+         uint64_t *candidates,
+         size_t &count
+      ) {
+         constexpr uint64_t lanes = 64 / sizeof(Ty);
+         constexpr uint64_t all_lanes = lanes == 64 ? ~0ULL : (1ULL << lanes) - 1;
+
+         for (; position + lanes - 1 <= last_start; position += lanes) {
+            if (count + lanes > candidate_buffer_size) {
+               return position;
+            }
+
+            const Ty *batch = data + position;
+
+            uint64_t mask = diff_equals_avx512<Ty, Order>(
+               batch + probes.first.current, batch + probes.first.previous, probes.first_expected, all_lanes);
+
+            // the second probe only compares the lanes that passed the first one
+            mask = diff_equals_avx512<Ty, Order>(
+               batch + probes.second.current, batch + probes.second.previous, probes.second_expected, mask);
+
+            append_candidates(position, mask, candidates, count);
+         }
+
+         return scan_candidates_scalar<Ty, Order>(data, position, last_start, probes, candidates, count);
+      }
+
+#endif // MMOORE_HAS_X86_KERNELS
+
+      /**
+       * Picks the candidate scanner compiled for the given (already resolved) tier and byte order.
+       * @return The scanner, or nullptr when the tier has no vectorized kernels
+       */
+      template <class Ty, Endianness Order>
+      CandidateScanner<Ty> select_candidate_scanner(InstructionSet instruction_set) {
+         switch (instruction_set) {
+#if defined(MMOORE_HAS_X86_KERNELS)
+            case InstructionSet::AVX512: return &scan_candidates_avx512<Ty, Order>;
+            case InstructionSet::AVX2: return &scan_candidates_avx2<Ty, Order>;
+            case InstructionSet::SSE42: return &scan_candidates_sse42<Ty, Order>;
+            case InstructionSet::SSE2: return &scan_candidates_sse2<Ty, Order>;
+#endif
+            default: return nullptr;
+         }
+      }
+
+   } // namespace simd
+} // namespace mmoore
+
+#endif // MONKEY_CORE_SIMD_KERNELS_HPP
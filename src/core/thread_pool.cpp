@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "thread_pool.hpp"
+#include "debug_logging.hpp"
+
+#include <algorithm>
+#include <exception>
+
+mmoore::ThreadPool::ThreadPool(size_t num_threads) {
+   std::lock_guard<std::mutex> lock(mutex);
+   grow(std::max<size_t>(num_threads, 1));
+}
+
+mmoore::ThreadPool::~ThreadPool() {
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+   }
+
+   jobs_available.notify_all();
+
+   for (auto &thread : threads) {
+      thread.join();
+   }
+}
+
+mmoore::ThreadPool &mmoore::ThreadPool::shared() {
+   static ThreadPool pool(std::thread::hardware_concurrency());
+   return pool;
+}
+
+size_t mmoore::ThreadPool::size() const {
+   std::lock_guard<std::mutex> lock(mutex);
+   return threads.size();
+}
+
+void mmoore::ThreadPool::run(size_t num_tasks, const std::function<void(size_t)> &task) {
+   if (num_tasks == 0) {
+      return;
+   }
+
+   std::mutex done_mutex;
+   std::condition_variable all_done;
+   size_t remaining = num_tasks;
+   std::exception_ptr first_error;
+
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+
+      // honors requests for more threads than cores (the pool never shrinks)
+      grow(num_tasks);
+
+      for (size_t index = 0; index < num_tasks; ++index) {
+         jobs.emplace_back([&, index]() {
+            std::exception_ptr error;
+
+            try {
+               task(index);
+            }
+            catch (...) {
+               error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> done_lock(done_mutex);
+
+            if (error && !first_error) {
+               first_error = error;
+            }
+
+            if (--remaining == 0) {
+               all_done.notify_one();
+            }
+         });
+      }
+   }
+
+   jobs_available.notify_all();
+
+   std::unique_lock<std::mutex> done_lock(done_mutex);
+   all_done.wait(done_lock, [&remaining]() { return remaining == 0; });
+
+   if (first_error) {
+      std::rethrow_exception(first_error);
+   }
+}
+
+void mmoore::ThreadPool::grow(size_t num_threads) {
+   while (threads.size() < num_threads) {
+      threads.emplace_back(&ThreadPool::worker_loop, this);
+   }
+
+   MMOORE_LOG("ThreadPool: ", threads.size(), " threads");
+}
+
+void mmoore::ThreadPool::worker_loop() {
+   for (;;) {
+      std::function<void()> job;
+
+      {
+         std::unique_lock<std::mutex> lock(mutex);
+         jobs_available.wait(lock, [this]() { return stopping || !jobs.empty(); });
+
+         if (stopping && jobs.empty()) {
+            return;
+         }
+
+         job = std::move(jobs.front());
+         jobs.pop_front();
+      }
+
+      job();
+   }
+}
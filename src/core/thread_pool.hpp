@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef MONKEY_CORE_THREAD_POOL_HPP
+#define MONKEY_CORE_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mmoore {
+
+   /**
+    * Persistent worker threads, shared by consecutive searches so they don't pay for
+    * creating threads. Work is handed out in batches of tasks; each task typically pulls
+    * its own work items (e.g. blocks) from a shared atomic counter.
+    */
+   class ThreadPool {
+   public:
+      explicit ThreadPool(size_t num_threads);
+      ~ThreadPool();
+
+      ThreadPool(const ThreadPool &) = delete;
+      ThreadPool &operator=(const ThreadPool &) = delete;
+
+      /**
+       * Process-wide pool, started with one thread per core on first use.
+       */
+      static ThreadPool &shared();
+
+      size_t size() const;
+
+      /**
+       * Runs task(0) .. task(num_tasks - 1) on the pool's threads (adding threads if there
+       * are fewer than num_tasks) and waits for every one to finish. The first exception
+       * thrown by a task is rethrown here.
+       */
+      void run(size_t num_tasks, const std::function<void(size_t)> &task);
+
+   private:
+      mutable std::mutex mutex;
+      std::condition_variable jobs_available;
+      std::deque<std::function<void()>> jobs;
+      std::vector<std::thread> threads;
+      bool stopping = false;
+
+      // caller must hold the mutex
+      void grow(size_t num_threads);
+
+      void worker_loop();
+   };
+}
+
+#endif // MONKEY_CORE_THREAD_POOL_HPP
@@ -56,22 +56,22 @@ SettingsDialog::SettingsDialog(
    wxBoxSizer *searchbuf_sz = new wxBoxSizer(wxHORIZONTAL);
    wxStaticText *sb_label = new wxStaticText(this, wxID_ANY, _("Memory pool: "));
    wxSpinCtrl *sb_size = new wxSpinCtrl(this, MonkeyOptions_MemoryPool, wxEmptyString, wxDefaultPosition, wxSize(50, 24));
-   wxStaticText *sb_unit = new wxStaticText(this, wxID_ANY, _(" MB"));
+   wxStaticText *sb_unit = new wxStaticText(this, wxID_ANY, _(" MB (0 = auto)"));
    searchbuf_sz->Add(sb_label, wxSizerFlags().Border(wxRIGHT).Center());
    searchbuf_sz->Add(sb_size, wxSizerFlags().Border(wxRIGHT).Center());
    searchbuf_sz->Add(sb_unit, wxSizerFlags().Border(wxRIGHT).Center());
 
-   sb_size->SetRange(1, 64);
+   sb_size->SetRange(0, 64);
 
    wxBoxSizer *smt_sz = new wxBoxSizer(wxHORIZONTAL);
    wxStaticText *smt_label = new wxStaticText(this, wxID_ANY, _("Search threads: "));
    wxSpinCtrl *smt_numthreads = new wxSpinCtrl(this, MonkeyOptions_MaxNumThreads, wxEmptyString, wxDefaultPosition, wxSize(50, 24));
-   wxStaticText *smt_units = new wxStaticText(this, wxID_ANY, _(" threads"));
+   wxStaticText *smt_units = new wxStaticText(this, wxID_ANY, _(" threads (0 = auto)"));
    smt_sz->Add(smt_label, wxSizerFlags().Border(wxRIGHT).Center());
    smt_sz->Add(smt_numthreads, wxSizerFlags().Border(wxRIGHT).Center());
    smt_sz->Add(smt_units, wxSizerFlags().Border(wxRIGHT).Center());
 
-   smt_numthreads->SetRange(1, 16);
+   smt_numthreads->SetRange(0, 64);
 
    wxStaticBoxSizer *perf_sz = new wxStaticBoxSizer(new wxStaticBox(this, wxID_ANY, _("Performance")), wxVERTICAL);
    perf_sz->Add(searchbuf_sz, wxSizerFlags().Border(wxALL ^ wxBOTTOM));
@@ -386,6 +386,9 @@ MonkeyFrame::~MonkeyFrame ()
 template <> std::vector<mmoore::SearchResult<uint8_t>> &MonkeyFrame::lastResults<uint8_t> () { return last_results8; }
 template <> std::vector<mmoore::SearchResult<uint16_t>> &MonkeyFrame::lastResults<uint16_t> () { return last_results16; }
 
+template <> std::vector<mmoore::ResultGroup<uint8_t>> &MonkeyFrame::lastGroups<uint8_t> () { return last_groups8; }
+template <> std::vector<mmoore::ResultGroup<uint16_t>> &MonkeyFrame::lastGroups<uint16_t> () { return last_groups16; }
+
 /**
 * Method called when the browse button is pressed.
 * @param event not used
@@ -675,9 +678,9 @@ void MonkeyFrame::OnCreateTbl (wxCommandEvent &WXUNUSED(event))
 
       TableCreatorDialog tbldiag(this, _("Create table file"), prefs, images, wxSize(500, 440));
 
-      auto values_map = results.at(sel_item.GetData()).values_map;
+      const auto &values_map = results.at(sel_item.GetData()).values_map;
 
-      tbldiag.InitTableData<_DataType>(values_map, byteorder_little);
+      tbldiag.InitTableData<_DataType>(*values_map, byteorder_little);
       tbldiag.CenterOnParent();
       tbldiag.ShowModal();
    }
@@ -792,6 +795,7 @@ void MonkeyFrame::OnClear (wxCommandEvent &WXUNUSED(event))
 
    search_done = false;
    lastResults<_DataType>().clear();
+   lastGroups<_DataType>().clear();
 }
 
 void MonkeyFrame::OnOptions (wxCommandEvent &WXUNUSED(event))
@@ -1191,6 +1195,7 @@ bool MonkeyFrame::StartSearchThread (mmoore::SearchConfig &config)
       chronometer.Start();
       
       lastResults<_DataType>().clear();
+      lastGroups<_DataType>().clear();
       
       search_in_progress = true;
       worker->SetPriority(25);
@@ -1220,8 +1225,21 @@ void MonkeyFrame::ShowResults (bool showAll)
    uint32_t numBytes = static_cast<uint32_t>(sizeof(_DataType)) * 2;
    wxString hexValueFmt = wxString::Format(wxT("%%c=%%0%uX "), numBytes);
 
-   std::vector<typename MonkeyMoore<_DataType>::equivalency_map> unique;
-   auto results = lastResults<_DataType>();
+   const auto &results = lastResults<_DataType>();
+
+   // without the repeated results, only the first result of each encoding is listed
+   std::vector<size_t> shown;
+
+   if (showAll)
+   {
+      shown.resize(results.size());
+      std::iota(shown.begin(), shown.end(), 0);
+   }
+   else
+   {
+      for (const auto &group : lastGroups<_DataType>())
+         shown.push_back(group.first_index);
+   }
 
    // index of the element being inserted in the wxListCtrl
    long curListIndex = 0;
@@ -1233,40 +1251,33 @@ void MonkeyFrame::ShowResults (bool showAll)
 
       result_box->Freeze();
 
-      for (uint32_t i = 0; i < results.size(); i++)
+      for (size_t i : shown)
       {
-         const auto &[result_offset, result_map, result_preview] = results[i];
+         const auto &[result_offset, result_map, result_preview, result_keyword_id] = results[i];
 
-         // if another result with the same values was already inserted in the list, don't insert
-         if (!std::count(unique.begin(), unique.end(), result_map))
-         {
-            if (!showAll)
-               unique.push_back(result_map);
-
-            bool hex_offset = prefs.getBool(wxT("settings/display-offset-mode"), wxT("hex"));
-            wxString offset = wxString::Format(hex_offset ? wxT("0x%llX") : wxT("%lld"), result_offset);
+         bool hex_offset = prefs.getBool(wxT("settings/display-offset-mode"), wxT("hex"));
+         wxString offset = wxString::Format(hex_offset ? wxT("0x%llX") : wxT("%lld"), result_offset);
 
-            result_box->InsertItem(curListIndex, offset);
-            result_box->SetItemData(curListIndex, i);
+         result_box->InsertItem(curListIndex, offset);
+         result_box->SetItemData(curListIndex, i);
 
-            wxString values;
+         wxString values;
 
-            for (auto j = result_map.cbegin(); j != result_map.cend(); j++)
-            {
-               const auto &[character, hex_value] = *j;
-               // swap bytes acording to the endianness the search was performed on
-               _DataType value_swapped = byteorder_little ?
-                  swap_on_le<_DataType>(hex_value) :
-                  swap_on_be<_DataType>(hex_value);
+         for (auto j = result_map->cbegin(); j != result_map->cend(); j++)
+         {
+            const auto &[character, hex_value] = *j;
+            // swap bytes acording to the endianness the search was performed on
+            _DataType value_swapped = byteorder_little ?
+               swap_on_le<_DataType>(hex_value) :
+               swap_on_be<_DataType>(hex_value);
 
-               values += wxString::Format(hexValueFmt, static_cast<int>(character), value_swapped);
-            }
+            values += wxString::Format(hexValueFmt, static_cast<int>(character), value_swapped);
+         }
 
-            result_box->SetItem(curListIndex, 1, values);
-            result_box->SetItem(curListIndex, search_relative ? 2 : 1, wxString::FromUTF8(result_preview));
+         result_box->SetItem(curListIndex, 1, values);
+         result_box->SetItem(curListIndex, search_relative ? 2 : 1, wxString::FromUTF8(result_preview));
 
-            curListIndex++;
-         }
+         curListIndex++;
       }
 
       result_box->Thaw();
@@ -1274,7 +1285,7 @@ void MonkeyFrame::ShowResults (bool showAll)
 
       wxString counterLabel = wxString::Format(
          wxT("%d"), 
-         static_cast<int>(showAll ? results.size() : unique.size())
+         static_cast<int>(shown.size())
       );
 
       GetWindow<wxStaticText>(MonkeyMoore_Counter)->SetLabel(counterLabel);
@@ -1310,6 +1321,9 @@ void MonkeyFrame::OnThreadCompleted (wxThreadEvent &WXUNUSED(event))
       GetWindow<wxStaticText>(MonkeyMoore_ElapsedTime)->SetLabel(format) :
       GetWindow<wxStaticText>(MonkeyMoore_ElapsedTime)->SetLabel(_("No results found."));
 
+   // grouped once, so toggling the repeated results doesn't go over them again
+   lastGroups<_DataType>() = mmoore::group_by_encoding(lastResults<_DataType>());
+
    bool showAll = IsChecked(MonkeyMoore_AllResults);
    
    ShowResults<_DataType>(showAll);
@@ -1326,6 +1340,7 @@ void MonkeyFrame::OnThreadAborted (wxThreadEvent &WXUNUSED(event))
 
    UpdateSearchStatus(_("Search was aborted."));
    lastResults<_DataType>().clear();
+   lastGroups<_DataType>().clear();
    SetCurrentProgress(0);
 }
 
@@ -1334,6 +1349,7 @@ void MonkeyFrame::OnThreadFailed (wxThreadEvent &event)
 {
    UpdateSearchStatus(_("Search failed."));
    lastResults<_DataType>().clear();
+   lastGroups<_DataType>().clear();
    SetCurrentProgress(0);
 
    wxMessageBox(event.GetString(), _("Search Error"), wxOK | wxICON_ERROR, this);
@@ -6,6 +6,7 @@
 #include "constants.hpp"
 #include "mmoore/monkey_moore.hpp"
 #include "mmoore/search_engine.hpp"
+#include "mmoore/result_groups.hpp"
 #include "monkey_prefs.hpp"
 
 #include <wx/imaglist.h>
@@ -135,6 +136,14 @@ private:
    template <typename _DataType>
       std::vector<mmoore::SearchResult<_DataType>> &lastResults();
 
+   /**
+   * Get a reference to the last search results grouped by encoding.
+   * @tparam _Datatype (must be either u8 or u16)
+   * @return A vector containing one group per encoding of the last results of _Type
+   */
+   template <typename _DataType>
+      std::vector<mmoore::ResultGroup<_DataType>> &lastGroups();
+
    int progressBoxHeight;                     /**< Height of the progress box in pixels */
 
    bool searchmode_8bits;                     /**< 8-bit search mode is selected?       */
@@ -152,6 +161,8 @@ private:
 
    std::vector<mmoore::SearchResult<uint8_t>> last_results8;   /**< Results from the last 8-bit search   */
    std::vector<mmoore::SearchResult<uint16_t>> last_results16; /**< Results from the last 16-bit search  */
+   std::vector<mmoore::ResultGroup<uint8_t>> last_groups8;     /**< Last 8-bit results by encoding       */
+   std::vector<mmoore::ResultGroup<uint16_t>> last_groups16;   /**< Last 16-bit results by encoding      */
 
    DECLARE_EVENT_TABLE();
 };
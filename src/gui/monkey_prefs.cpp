@@ -23,8 +23,8 @@ void MonkeyPrefs::setDefaultValues () {
    values[wxT("settings/ui-remember-state")]     = wxT("true");
    values[wxT("settings/display-preview-width")] = wxT("50");
    values[wxT("settings/display-offset-mode")]   = wxT("hex");
-   values[wxT("settings/perf-memory-pool")]      = wxT("8388608");
-   values[wxT("settings/perf-search-threads")]   = wxT("4");
+   values[wxT("settings/perf-memory-pool")]      = wxT("0");
+   values[wxT("settings/perf-search-threads")]   = wxT("0");
 
    values[wxT("window/position-x")]              = wxT("0");
    values[wxT("window/position-y")]              = wxT("0");
@@ -8,6 +8,11 @@
 
 #include <catch2/catch_test_macros.hpp>
 #include <fstream>
+#include <functional>
+#include <atomic>
+#include <algorithm>
+#include <vector>
+#include <cstdint>
 
 namespace mmoore {
    template<typename DataType>
@@ -62,6 +67,208 @@ private:
    }
 };
 
+/**
+ * Text the engine tests repeat to get plenty of matches: each copy holds "theater" 3 times,
+ * "theatrical" twice and "thanked" once.
+ */
+inline const std::string repeated_text = 
+   "the theater's theatrical theatergoer thanked the theatrical theater's theatrics ";
+
+/**
+ * Writes `repeats` copies of repeated_text to a temporary file, shifting every value of copy i
+ * by copy_shift(i) (so copies can be in different encodings) and storing them in byte_order.
+ */
+template <typename DataType>
+TempFile<DataType> make_repeated_text_file(
+   int repeats, 
+   const std::function<int(int)> &copy_shift,
+   mmoore::Endianness byte_order = mmoore::system_endianness
+) {
+   std::vector<DataType> data;
+   data.reserve(repeats * repeated_text.size());
+
+   for (int i = 0; i < repeats; ++i) {
+      const int shift = copy_shift(i);
+
+      for (char c : repeated_text) {
+         auto value = static_cast<DataType>(c + shift);
+         data.push_back(byte_order == mmoore::system_endianness ? value : mmoore::swap_always(value));
+      }
+   }
+
+   return TempFile<DataType>(data);
+}
+
+template <typename DataType>
+TempFile<DataType> make_repeated_text_file(
+   int repeats, 
+   int shift, 
+   mmoore::Endianness byte_order = mmoore::system_endianness
+) {
+   return make_repeated_text_file<DataType>(repeats, [shift](int) { return shift; }, byte_order);
+}
+
+/**
+ * Config searching the given file, everything else left at its default.
+ */
+template <typename DataType>
+mmoore::SearchConfig make_search_config(const TempFile<DataType> &file) {
+   mmoore::SearchConfig config;
+   config.file_path = file.path;
+
+   return config;
+}
+
+// abort flag of the searches that are never aborted
+inline std::atomic<bool> never_abort{false};
+
+/**
+ * Small linear congruential generator, so the random test data is the same on every platform.
+ */
+class TestRandom {
+public:
+   explicit TestRandom(uint32_t seed) : state(seed) {}
+
+   // next number in [0, range)
+   int next(int range) {
+      state = state * 1103515245u + 12345u;
+      return static_cast<int>((state >> 16) % static_cast<uint32_t>(range));
+   }
+
+private:
+   uint32_t state;
+};
+
+/**
+ * Low entropy data for comparing the search strategies: count values picked at random out of
+ * num_symbols consecutive ones starting at base (wrapping around the data type). When
+ * spread_every is given, every spread_every-th value is moved 256 up, so values 256 apart
+ * (which share table entries) show up too. The same seed gives the same symbols at every width.
+ */
+template <typename DataType>
+std::vector<DataType> make_random_data(
+   uint32_t seed, 
+   size_t count, 
+   int num_symbols, 
+   int base, 
+   size_t spread_every = 0
+) {
+   TestRandom random(seed);
+   std::vector<DataType> data(count);
+
+   for (size_t i = 0; i < count; ++i) {
+      const int spread = spread_every > 0 && i % spread_every == 0 ? 0x100 : 0;
+      data[i] = static_cast<DataType>(random.next(num_symbols) + base + spread);
+   }
+
+   return data;
+}
+
+/**
+ * Writes the literals of a keyword into data at offset, encoded with 'a' at base (in ASCII
+ * order otherwise), so the keyword is found there. Values under wildcards are left as they were.
+ */
+template <typename DataType>
+void plant_keyword(
+   std::vector<DataType> &data, 
+   size_t offset, 
+   const std::vector<CharType> &keyword, 
+   int base, 
+   CharType wildcard = '*'
+) {
+   for (size_t k = 0; k < keyword.size(); ++k) {
+      if (keyword[k] != wildcard) {
+         data[offset + k] = static_cast<DataType>(static_cast<int>(keyword[k]) - 'a' + base);
+      }
+   }
+}
+
+/**
+ * Reference relative search, which checks every window against every literal of the keyword
+ * instead of relying on the searchers' tables and shifts. It follows their rules: the less
+ * frequent case of a keyword with case changes is left to the wildcards, and the differences
+ * wrap around the data type once there are wildcards (plain keywords match exactly). A match
+ * may only overlap the previous one by its last character (past the leading wildcards), and
+ * encodings come from the first literal (and the first character of the opposing case, if any).
+ */
+template <typename DataType>
+std::vector<typename MonkeyMoore<DataType>::result_type> naive_relative_search(
+   const std::vector<CharType> &keyword, 
+   const std::vector<DataType> &data, 
+   CharType wildcard = '*'
+) {
+   const auto uppercase_count = std::count_if(keyword.begin(), keyword.end(), is_ascii_upper);
+   const auto lowercase_count = std::count_if(keyword.begin(), keyword.end(), is_ascii_lower);
+
+   const bool has_case_change = uppercase_count > 0 && lowercase_count > 0;
+   const bool mostly_lowercase = lowercase_count > uppercase_count;
+   const bool wraps = has_case_change || std::count(keyword.begin(), keyword.end(), wildcard) > 0;
+
+   std::vector<size_t> literals;
+
+   for (size_t k = 0; k < keyword.size(); ++k) {
+      // on a tie the uppercase characters are left to the wildcards
+      const bool is_minority_case = has_case_change
+         && (uppercase_count > lowercase_count ? is_ascii_lower(keyword[k]) : is_ascii_upper(keyword[k]));
+
+      if (keyword[k] != wildcard && !is_minority_case) {
+         literals.push_back(k);
+      }
+   }
+
+   std::vector<typename MonkeyMoore<DataType>::result_type> results;
+
+   if (literals.empty() || data.size() < keyword.size()) {
+      return results;
+   }
+
+   const size_t first = literals.front();
+   const size_t match_advance = std::max<size_t>(keyword.size() - 1 - first, 1);
+   size_t next_allowed = 0;
+
+   for (size_t offset = 0; offset + keyword.size() <= data.size(); ++offset) {
+      if (offset < next_allowed) {
+         continue;
+      }
+
+      const DataType *window = data.data() + offset;
+
+      const bool is_match = std::all_of(literals.begin(), literals.end(), [&](size_t k) {
+         const int difference = static_cast<int>(window[k]) - static_cast<int>(window[first]);
+         const int expected = static_cast<int>(keyword[k]) - static_cast<int>(keyword[first]);
+
+         return wraps 
+            ? static_cast<DataType>(difference) == static_cast<DataType>(expected) 
+            : difference == expected;
+      });
+
+      if (!is_match) {
+         continue;
+      }
+
+      const int distance = static_cast<int>(window[first]) - static_cast<int>(keyword[first]);
+      int opposing_distance = distance;
+
+      if (has_case_change) {
+         auto opposing = std::find_if(keyword.begin(), keyword.end(), [&](CharType c) {
+            return mostly_lowercase ? is_ascii_upper(c) : is_ascii_lower(c);
+         });
+
+         const size_t k = static_cast<size_t>(opposing - keyword.begin());
+         opposing_distance = static_cast<int>(window[k]) - static_cast<int>(keyword[k]);
+      }
+
+      typename MonkeyMoore<DataType>::encoding_type encoding;
+      encoding.base = static_cast<DataType>('a' + (mostly_lowercase || !has_case_change ? distance : opposing_distance));
+      encoding.upper_base = static_cast<DataType>('A' + (mostly_lowercase && has_case_change ? opposing_distance : distance));
+
+      results.push_back({ offset, encoding });
+      next_allowed = offset + match_advance;
+   }
+
+   return results;
+}
+
 inline std::vector<CharType> to_vector(const std::u32string &from) {
    return std::vector<CharType>(from.begin(), from.end());
 }
@@ -72,14 +279,15 @@ inline std::vector<uint8_t> to_vector(const std::string &from) {
 
 template <class DataType>
 void assert_matching_ascii_result(
+   const MonkeyMoore<DataType> &searcher,
    const typename MonkeyMoore<DataType>::result_type &result, 
    const uint64_t expected_offset,
    const DataType expected_lower_a_value,
    const DataType expected_upper_a_value
 ) {
-   CHECK(result.first == expected_offset);
+   CHECK(result.offset == expected_offset);
 
-   auto &equivalency_map = result.second;
+   auto equivalency_map = searcher.make_equivalency_map(result.encoding);
 
    CHECK(equivalency_map.at('a') == expected_lower_a_value);
    CHECK(equivalency_map.at('A') == expected_upper_a_value);
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "mmoore/cpu_dispatch.hpp"
+#include "mmoore/cpu_topology.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("CPU dispatch: instruction set resolution", "[core][dispatch]") {
+   const auto detected = mmoore::detect_instruction_set();
+
+   SECTION("Detection never reports the automatic placeholder") {
+      CHECK(detected != mmoore::InstructionSet::Automatic);
+   }
+
+   SECTION("Explicit requests are honored when supported by the CPU") {
+      CHECK(mmoore::resolve_instruction_set(mmoore::InstructionSet::Scalar) == mmoore::InstructionSet::Scalar);
+      CHECK(mmoore::resolve_instruction_set(detected) == detected);
+   }
+
+   SECTION("Requests above the supported tier are clamped") {
+      auto resolved = mmoore::resolve_instruction_set(mmoore::InstructionSet::AVX512);
+      CHECK(static_cast<int>(resolved) <= static_cast<int>(detected));
+   }
+
+   SECTION("Tier names round-trip through the parser") {
+      for (auto tier : { 
+         mmoore::InstructionSet::Scalar, 
+         mmoore::InstructionSet::SSE2, 
+         mmoore::InstructionSet::SSE42, 
+         mmoore::InstructionSet::AVX2, 
+         mmoore::InstructionSet::AVX512 
+      }) {
+         CHECK(mmoore::parse_instruction_set(mmoore::to_string(tier)) == tier);
+      }
+
+      CHECK(mmoore::parse_instruction_set("AVX-512") == mmoore::InstructionSet::AVX512);
+      CHECK(mmoore::parse_instruction_set("SSE4_2") == mmoore::InstructionSet::SSE42);
+      CHECK(mmoore::parse_instruction_set("mmx") == mmoore::InstructionSet::Automatic);
+   }
+}
+
+TEST_CASE("CPU topology: core counts and caches", "[core][topology]") {
+   const auto &topology = mmoore::detect_cpu_topology();
+
+   CHECK(topology.physical_cores >= 1);
+   CHECK(topology.physical_cores <= topology.logical_cores);
+
+   // queried once
+   CHECK(&mmoore::detect_cpu_topology() == &topology);
+
+#if defined(__linux__) && (defined(__x86_64__) || defined(__i386__))
+   CHECK(topology.l2_cache_size > 0);
+#endif
+}
@@ -4,6 +4,7 @@
 #include "common.hpp"
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
 #include <numeric>
 #include <codecvt>
 
@@ -23,7 +24,7 @@ TEST_CASE("Search algorithm: no wildcard support", "[core][relative]") {
             auto results = searcher.search(data.data(), data.size());
             REQUIRE(results.size() == 1);
 
-            assert_matching_ascii_result<uint8_t>(results[0], 6, 'a' + 3, 'A' + 3);
+            assert_matching_ascii_result<uint8_t>(searcher, results[0], 6, 'a' + 3, 'A' + 3);
          }
 
          SECTION("Returns no results when no match is found") {
@@ -45,9 +46,9 @@ TEST_CASE("Search algorithm: no wildcard support", "[core][relative]") {
             
             auto results = searcher.search(data.data(), data.size());
             REQUIRE(results.size() == 1);
-            CHECK(results[0].first == 8);
+            CHECK(results[0].offset == 8);
 
-            assert_char_seq_result(custom_seq, results[0].second, to_vector("abcdefghijklmnopqrstuvwxyz"));
+            assert_char_seq_result(custom_seq, searcher.make_equivalency_map(results[0].encoding), to_vector("abcdefghijklmnopqrstuvwxyz"));
          }
       }
    }
@@ -66,7 +67,7 @@ TEST_CASE("Search algorithm: no wildcard support", "[core][relative]") {
 
             auto results = searcher.search(data.data(), data.size());
             REQUIRE(results.size() == 1);
-            assert_matching_ascii_result<uint16_t>(results[0], 12, 'a' - 16, 'A' - 16);
+            assert_matching_ascii_result<uint16_t>(searcher, results[0], 12, 'a' - 16, 'A' - 16);
          }
 
          SECTION("Returns no results when no match is found") {
@@ -94,12 +95,12 @@ TEST_CASE("Search algorithm: no wildcard support", "[core][relative]") {
             
             auto results = searcher.search(data.data(), data.size());
             REQUIRE(results.size() == 1);
-            CHECK(results[0].first == 4);
+            CHECK(results[0].offset == 4);
 
 
             std::vector<uint16_t> expected_values(49);
             std::iota(expected_values.begin(), expected_values.end(), 1);
-            assert_char_seq_result(custom_seq, results[0].second, expected_values);
+            assert_char_seq_result(custom_seq, searcher.make_equivalency_map(results[0].encoding), expected_values);
          }
       }
    }
@@ -122,8 +123,8 @@ TEST_CASE("Search algorithm: with wildcard support", "[core][relative][wildcard]
                auto results = searcher.search(data.data(), data.size());
                REQUIRE(results.size() == 2);
 
-               assert_matching_ascii_result<uint8_t>(results[0], 3, 'a' + 8, 'A' + 8);
-               assert_matching_ascii_result<uint8_t>(results[1], 25, 'a' + 8, 'A' + 8);
+               assert_matching_ascii_result<uint8_t>(searcher, results[0], 3, 'a' + 8, 'A' + 8);
+               assert_matching_ascii_result<uint8_t>(searcher, results[1], 25, 'a' + 8, 'A' + 8);
             }
 
             SECTION("Returns correct values when a different wildcard character is used") {
@@ -133,7 +134,7 @@ TEST_CASE("Search algorithm: with wildcard support", "[core][relative][wildcard]
                auto results = searcher.search(data.data(), data.size());
                REQUIRE(results.size() == 1);
 
-               assert_matching_ascii_result<uint8_t>(results[0], 9, 'a' + 8, 'A' + 8);               
+               assert_matching_ascii_result<uint8_t>(searcher, results[0], 9, 'a' + 8, 'A' + 8);               
             }
 
             SECTION("Returns no results when no match is found") {
@@ -159,9 +160,9 @@ TEST_CASE("Search algorithm: with wildcard support", "[core][relative][wildcard]
                auto results = searcher.search(data.data(), data.size());
                REQUIRE(results.size() == 3);
 
-               assert_matching_ascii_result<uint8_t>(results[0], 3, 'a' -32, 'A' + 24);
-               assert_matching_ascii_result<uint8_t>(results[1], 19, 'a' -32, 'A' + 24);
-               assert_matching_ascii_result<uint8_t>(results[2], 25, 'a' - 32, 'A' + 24);
+               assert_matching_ascii_result<uint8_t>(searcher, results[0], 3, 'a' -32, 'A' + 24);
+               assert_matching_ascii_result<uint8_t>(searcher, results[1], 19, 'a' -32, 'A' + 24);
+               assert_matching_ascii_result<uint8_t>(searcher, results[2], 25, 'a' - 32, 'A' + 24);
             }
 
             SECTION("Returns no results when no match is found") {
@@ -184,9 +185,9 @@ TEST_CASE("Search algorithm: with wildcard support", "[core][relative][wildcard]
             
             auto results = searcher.search(data.data(), data.size());
             REQUIRE(results.size() == 1);
-            CHECK(results[0].first == 8);
+            CHECK(results[0].offset == 8);
 
-            assert_char_seq_result(custom_seq, results[0].second, to_vector("abcdefghijklmnopqrstuvwxyz"));
+            assert_char_seq_result(custom_seq, searcher.make_equivalency_map(results[0].encoding), to_vector("abcdefghijklmnopqrstuvwxyz"));
          }
       }
    }
@@ -206,9 +207,9 @@ TEST_CASE("Search algorithm: with wildcard support", "[core][relative][wildcard]
 
             auto results = searcher.search(data.data(), data.size());
             REQUIRE(results.size() == 1);
-            CHECK(results[0].first == 31);
-            CHECK(results[0].second['a'] == static_cast<uint16_t>('a' + 15));
-            CHECK(results[0].second['A'] == static_cast<uint16_t>('A' - 9));
+            CHECK(results[0].offset == 31);
+            CHECK(searcher.make_equivalency_map(results[0].encoding).at('a') == static_cast<uint16_t>('a' + 15));
+            CHECK(searcher.make_equivalency_map(results[0].encoding).at('A') == static_cast<uint16_t>('A' - 9));
          }
 
          SECTION("Returns no results when no match is found") {
@@ -237,11 +238,11 @@ TEST_CASE("Search algorithm: with wildcard support", "[core][relative][wildcard]
             
             auto results = searcher.search(data.data(), data.size());
             REQUIRE(results.size() == 1);
-            CHECK(results[0].first == 5);
+            CHECK(results[0].offset == 5);
 
             std::vector<uint16_t> expected_values(52);
             std::iota(expected_values.begin(), expected_values.end(), 1);
-            assert_char_seq_result(custom_seq, results[0].second, expected_values);
+            assert_char_seq_result(custom_seq, searcher.make_equivalency_map(results[0].encoding), expected_values);
          }
       }
    }
@@ -260,8 +261,8 @@ TEST_CASE("Search algorithm: value scan mode", "[core][value-scan]") {
 
          auto results = searcher.search(data.data(), data.size());
          REQUIRE(results.size() == 2);
-         CHECK(results[0].first == 4);
-         CHECK(results[1].first == 21);
+         CHECK(results[0].offset == 4);
+         CHECK(results[1].offset == 21);
       }
 
       SECTION("Returns no results when no match is found") {
@@ -287,8 +288,8 @@ TEST_CASE("Search algorithm: value scan mode", "[core][value-scan]") {
 
          auto results = searcher.search(data.data(), data.size());
          REQUIRE(results.size() == 2);
-         CHECK(results[0].first == 4);
-         CHECK(results[1].first == 19);
+         CHECK(results[0].offset == 4);
+         CHECK(results[1].offset == 19);
       }
 
       SECTION("Returns no results when no match is found") {
@@ -324,7 +325,7 @@ TEST_CASE("Search algorithm: Boyer-Moore skip table allocation", "[core][interna
       auto results = searcher.search(data.data(), data.size());
       REQUIRE(results.size() == 1);
 
-      CHECK(results[0].first == 9);
+      CHECK(results[0].offset == 9);
    }
 
    SECTION("Skip table correctly handles maximum representable 16-bit value (0xFFFF)") {
@@ -339,7 +340,441 @@ TEST_CASE("Search algorithm: Boyer-Moore skip table allocation", "[core][interna
       auto results = searcher.search(data.data(), data.size());
       REQUIRE(results.size() == 1);
 
-      CHECK(results[0].first == 9);
+      CHECK(results[0].offset == 9);
    }
 }
 
+
+TEST_CASE("Search algorithm: vectorized kernel", "[core][relative][simd]") {
+   /*
+   * The vectorized search only filters candidates with SIMD compares, so its results must
+   * be identical to the scalar Boyer-Moore search. Low entropy data produces plenty of
+   * partial matches, which exercises both the candidate verification and the skip logic.
+   */
+   std::vector<CharType> keyword = to_vector(U"abacab");
+
+   const mmoore::InstructionSet vector_tiers[] = {
+      mmoore::InstructionSet::SSE2,
+      mmoore::InstructionSet::SSE42,
+      mmoore::InstructionSet::AVX2,
+      mmoore::InstructionSet::AVX512
+   };
+
+   // every section draws the same symbols
+   const uint32_t seed = 12345;
+
+   SECTION("8-bit results match the scalar search") {
+      auto data = make_random_data<uint8_t>(seed, 4099, 4, 0x40);
+
+      MonkeyMoore<uint8_t> scalar(keyword);
+      scalar.set_algorithm(SearchAlgorithm::BoyerMoore);
+
+      auto expected = scalar.search(data.data(), data.size());
+      REQUIRE(!expected.empty());
+
+      // every tier is checked, as the ones above the CPU's capabilities are clamped
+      for (auto tier : vector_tiers) {
+         MonkeyMoore<uint8_t> vectorized(keyword);
+         vectorized.set_algorithm(SearchAlgorithm::Vectorized);
+         vectorized.set_instruction_set(tier);
+
+         CAPTURE(mmoore::to_string(tier));
+         REQUIRE(vectorized.search(data.data(), data.size()) == expected);
+      }
+   }
+
+   SECTION("16-bit results match the scalar search") {
+      auto data = make_random_data<uint16_t>(seed, 4099, 4, 0x3040);
+
+      MonkeyMoore<uint16_t> scalar(keyword);
+      scalar.set_algorithm(SearchAlgorithm::BoyerMoore);
+
+      auto expected = scalar.search(data.data(), data.size());
+      REQUIRE(!expected.empty());
+
+      for (auto tier : vector_tiers) {
+         MonkeyMoore<uint16_t> vectorized(keyword);
+         vectorized.set_algorithm(SearchAlgorithm::Vectorized);
+         vectorized.set_instruction_set(tier);
+
+         CAPTURE(mmoore::to_string(tier));
+         REQUIRE(vectorized.search(data.data(), data.size()) == expected);
+      }
+   }
+
+   SECTION("Wildcard results match the scalar search") {
+      auto data = make_random_data<uint8_t>(seed, 4099, 4, 0x40);
+
+      std::u32string wildcard_keyword = GENERATE(U"*bacab", U"ab*cab", U"abac**", U"Abacab");
+      std::vector<CharType> keyword = to_vector(wildcard_keyword);
+
+      MonkeyMoore<uint8_t> scalar(keyword, '*');
+      scalar.set_algorithm(SearchAlgorithm::BoyerMoore);
+
+      auto expected = scalar.search(data.data(), data.size());
+      REQUIRE(!expected.empty());
+
+      for (auto tier : vector_tiers) {
+         MonkeyMoore<uint8_t> vectorized(keyword, '*');
+         vectorized.set_algorithm(SearchAlgorithm::Vectorized);
+         vectorized.set_instruction_set(tier);
+
+         CAPTURE(mmoore::to_string(tier));
+         REQUIRE(vectorized.search(data.data(), data.size()) == expected);
+      }
+   }
+
+   SECTION("Wildcard results match when the values wrap around") {
+      // regression: the scalar search indexed its skip table with unwrapped differences,
+      // jumping over the match at offset 1
+      std::vector<uint8_t> wrapping = { 0x00, 0x00, 0xFF, 0x00, 0x00, 0x01, 0x01 };
+
+      MonkeyMoore<uint8_t> scalar(to_vector(U"cbcc*"), '*');
+      scalar.set_algorithm(SearchAlgorithm::BoyerMoore);
+
+      auto results = scalar.search(wrapping.data(), wrapping.size());
+      REQUIRE(results.size() == 1);
+      CHECK(results[0].offset == 1);
+
+      // values straddling 0xFF -> 0x00 on every algorithm
+      auto data = make_random_data<uint8_t>(seed, 4099, 4, 0xFE);
+
+      std::u32string wildcard_keyword = GENERATE(U"*bacab", U"ab*cab", U"cbcc*", U"Abacab");
+      std::vector<CharType> keyword = to_vector(wildcard_keyword);
+
+      MonkeyMoore<uint8_t> reference(keyword, '*');
+      reference.set_algorithm(SearchAlgorithm::BoyerMoore);
+
+      auto expected = reference.search(data.data(), data.size());
+      REQUIRE(!expected.empty());
+
+      for (auto algorithm : { SearchAlgorithm::Automatic, SearchAlgorithm::Vectorized, SearchAlgorithm::BitParallel }) {
+         MonkeyMoore<uint8_t> searcher(keyword, '*');
+         searcher.set_algorithm(algorithm);
+
+         CAPTURE(static_cast<int>(algorithm));
+         REQUIRE(searcher.search(data.data(), data.size()) == expected);
+      }
+   }
+
+   SECTION("Scalar search does not skip matches after an early mismatch") {
+      // regression: the bad-character jump used to be measured from the end of the keyword
+      // instead of the mismatch position, skipping over the match at offset 3
+      std::vector<uint8_t> data = { 0x20, 0x10, 0x30, 0x30, 0x31, 0x31 };
+
+      MonkeyMoore<uint8_t> scalar(to_vector(U"aabb"));
+      scalar.set_algorithm(SearchAlgorithm::BoyerMoore);
+
+      auto results = scalar.search(data.data(), data.size());
+      REQUIRE(results.size() == 1);
+      CHECK(results[0].offset == 2);
+   }
+
+   SECTION("Scalar wildcard search does not skip matches after leading wildcards") {
+      // regression: the wildcard skip table kept the leftmost occurrence of each difference
+      std::vector<uint8_t> data = { 0x50, 0x52, 0x50, 0x52, 0x50, 0x52, 0x51 };
+
+      MonkeyMoore<uint8_t> scalar(to_vector(U"*acac"), '*');
+      scalar.set_algorithm(SearchAlgorithm::BoyerMoore);
+
+      auto results = scalar.search(data.data(), data.size());
+      REQUIRE(results.size() == 1);
+      CHECK(results[0].offset == 1);
+   }
+
+   SECTION("Scalar wildcard search moves past matches of two-character keywords") {
+      // regression: "Aa" and "Ab" normalize to a wildcard and a literal, and the scalar search
+      // advanced by 0 after each match, never returning
+      std::vector<uint8_t> data = to_vector("xAaBbAbCcab");
+      shift_alpha_values(data, 4, 4);
+
+      std::u32string case_change_keyword = GENERATE(U"Aa", U"Ab");
+      std::vector<CharType> keyword = to_vector(case_change_keyword);
+
+      auto expected = naive_relative_search(keyword, data);
+      REQUIRE(!expected.empty());
+
+      for (auto algorithm : { SearchAlgorithm::BoyerMoore, SearchAlgorithm::QGram }) {
+         MonkeyMoore<uint8_t> scalar(keyword, '*');
+         scalar.set_algorithm(algorithm);
+
+         CAPTURE(static_cast<int>(algorithm));
+         REQUIRE(scalar.search(data.data(), data.size()) == expected);
+      }
+   }
+}
+
+TEST_CASE("Search algorithm: good-suffix shifts", "[core][relative][good-suffix]") {
+   /*
+   * Periodic keywords over repetitive data are where the good-suffix rule takes over from
+   * the bad-character one, so the Boyer-Moore results are compared against the naive
+   * reference search, which checks every window instead of skipping.
+   */
+   std::u32string periodic_keyword = GENERATE(
+      U"aaab", U"baaaaaaa", U"abaabaab", U"abababab", U"aabaabaa",
+      U"b*aaaaaa", U"aa*ab*aab", U"*abab*ab", U"abab**", U"AaaB");
+
+   std::vector<CharType> keyword = to_vector(periodic_keyword);
+
+   // mostly 'a', one 'b' in five
+   TestRandom random(777);
+
+   std::vector<uint8_t> data(4099);
+   for (auto &value : data) {
+      value = static_cast<uint8_t>((random.next(5) == 0 ? 'b' : 'a') + 0x10);
+   }
+
+   CAPTURE(keyword);
+
+   MonkeyMoore<uint8_t> boyer_moore(keyword, '*');
+   boyer_moore.set_algorithm(SearchAlgorithm::BoyerMoore);
+
+   auto expected = naive_relative_search(keyword, data);
+   REQUIRE(!expected.empty());
+
+   REQUIRE(boyer_moore.search(data.data(), data.size()) == expected);
+}
+
+TEST_CASE("Search algorithm: q-gram shifts", "[core][relative][qgram]") {
+   /**
+    * The pair table is compared against the Boyer-Moore search over low-entropy data, where
+    * pairs of differences repeat often, for keywords of every length that uses it.
+    */
+   std::u32string qgram_keyword = GENERATE(
+      U"abc", U"aba", U"abcd", U"dcbad", U"abcabc", U"aaab", U"acbdabdc", U"abcdabdcacbd", U"zyx");
+
+   std::vector<CharType> keyword = to_vector(qgram_keyword);
+
+   // the 16-bit data also spreads some values 256 apart, which share a table entry
+   auto data8 = make_random_data<uint8_t>(31337, 8191, 4, 0x61);
+   auto data16 = make_random_data<uint16_t>(31337, 8191, 4, 0x3061, 7);
+
+   // the longer keywords are too unlikely to show up at random
+   for (size_t offset : {1000, 5000}) {
+      plant_keyword(data8, offset, keyword, 0x61);
+      plant_keyword(data16, offset, keyword, 0x3061);
+   }
+
+   CAPTURE(keyword);
+
+   MonkeyMoore<uint8_t> boyer_moore8(keyword);
+   MonkeyMoore<uint8_t> qgram8(keyword);
+   MonkeyMoore<uint16_t> boyer_moore16(keyword);
+   MonkeyMoore<uint16_t> qgram16(keyword);
+
+   boyer_moore8.set_algorithm(SearchAlgorithm::BoyerMoore);
+   qgram8.set_algorithm(SearchAlgorithm::QGram);
+   boyer_moore16.set_algorithm(SearchAlgorithm::BoyerMoore);
+   qgram16.set_algorithm(SearchAlgorithm::QGram);
+
+   auto expected8 = boyer_moore8.search(data8.data(), data8.size());
+   auto expected16 = boyer_moore16.search(data16.data(), data16.size());
+
+   REQUIRE(!expected8.empty());
+   REQUIRE(!expected16.empty());
+
+   REQUIRE(qgram8.search(data8.data(), data8.size()) == expected8);
+   REQUIRE(qgram16.search(data16.data(), data16.size()) == expected16);
+
+   // the q-gram path must also find keywords at the very start and end of the buffer
+   std::vector<uint8_t> exact(keyword.begin(), keyword.end());
+   auto edges = exact;
+   edges.insert(edges.end(), {0x00, 0x7F});
+   edges.insert(edges.end(), exact.begin(), exact.end());
+
+   auto results = qgram8.search(edges.data(), edges.size());
+   REQUIRE(results.size() == 2);
+   CHECK(results[0].offset == 0);
+   CHECK(results[1].offset == exact.size() + 2);
+}
+
+TEST_CASE("Search algorithm: bit-parallel automaton", "[core][relative][bit-parallel]") {
+   /**
+    * The automaton only tracks differences between adjacent literals, so the keywords below
+    * cover wildcards at every position, bridged differences, case changes and the 64 symbol
+    * limit (longer keywords fall back to the Boyer-Moore search). Results are compared against
+    * the naive reference search.
+    */
+   std::u32string pattern = GENERATE(as<std::u32string>{},
+      U"abc", U"*bcd", U"ab*cd", U"abcd*", U"a**b*c", U"**ab**", U"*a*b*c*", U"acbdabdc", 
+      U"AbcD", U"aBcDa", U"abab*abab",
+      std::u32string(65, U'a') + U"b",
+      U"b" + std::u32string(64, U'a'));
+
+   std::vector<CharType> keyword = to_vector(pattern);
+
+   auto data8 = make_random_data<uint8_t>(2024, 8191, 4, 0x61);
+   auto data16 = make_random_data<uint16_t>(2024, 8191, 4, 0x3061, 7);
+
+   // the longer keywords (up to 66 symbols) need something to match
+   for (size_t offset : {1000, 5000}) {
+      plant_keyword(data8, offset, keyword, 0x61);
+      plant_keyword(data16, offset, keyword, 0x3061);
+   }
+
+   CAPTURE(keyword);
+
+   MonkeyMoore<uint8_t> bit_parallel8(keyword, '*');
+   MonkeyMoore<uint16_t> bit_parallel16(keyword, '*');
+
+   bit_parallel8.set_algorithm(SearchAlgorithm::BitParallel);
+   bit_parallel16.set_algorithm(SearchAlgorithm::BitParallel);
+
+   auto expected8 = naive_relative_search(keyword, data8);
+   auto expected16 = naive_relative_search(keyword, data16);
+
+   REQUIRE(!expected8.empty());
+   REQUIRE(!expected16.empty());
+
+   REQUIRE(bit_parallel8.search(data8.data(), data8.size()) == expected8);
+   REQUIRE(bit_parallel16.search(data16.data(), data16.size()) == expected16);
+}
+
+TEST_CASE("Search algorithm: compact skip table", "[core][relative][skip-table]") {
+   /**
+    * 16-bit differences 512 apart share a skip table entry, which must only shorten the
+    * shifts. The data mixes each keyword difference with its aliases.
+    */
+   std::u32string pattern = GENERATE(as<std::u32string>{}, U"adgj", U"ab*de", U"jgda");
+   std::vector<CharType> keyword = to_vector(pattern);
+
+   uint32_t seed = 99;
+   auto next_step = [&seed]() {
+      seed = seed * 1103515245u + 12345u;
+      int step = static_cast<int>((seed >> 16) % 7) - 3;
+      return (seed >> 28) % 2 == 0 ? step : step + 512;
+   };
+
+   std::vector<uint16_t> data(8191);
+   uint16_t value = 0x3000;
+
+   for (auto &v : data) {
+      value = static_cast<uint16_t>(value + next_step());
+      v = value;
+   }
+
+   // plants a few matches between the aliased differences
+   for (size_t offset : {100, 2000, 5000}) {
+      for (size_t k = 0; k < keyword.size(); ++k) {
+         if (keyword[k] != '*') {
+            data[offset + k] = static_cast<uint16_t>(0x5000 + keyword[k]);
+         }
+      }
+   }
+
+   CAPTURE(keyword);
+
+   MonkeyMoore<uint16_t> boyer_moore(keyword, '*');
+   MonkeyMoore<uint16_t> reference(keyword, '*');
+
+   boyer_moore.set_algorithm(SearchAlgorithm::BoyerMoore);
+   reference.set_algorithm(SearchAlgorithm::BitParallel);
+
+   auto expected = reference.search(data.data(), data.size());
+   REQUIRE(expected.size() >= 3);
+
+   REQUIRE(boyer_moore.search(data.data(), data.size()) == expected);
+}
+
+TEST_CASE("Search algorithm: foreign byte order", "[core][relative][byte-order]") {
+   /**
+    * Searching data in the foreign byte order must give the same results as searching
+    * the same values in the system's order, with every strategy. Values straddle a
+    * 256 boundary, so the differences of the unswapped bytes don't match by accident.
+    */
+   std::u32string pattern = GENERATE(as<std::u32string>{}, U"abcab", U"abacab", U"ab*cab", U"*bac*b", U"AbcaB");
+   std::vector<CharType> keyword = to_vector(pattern);
+
+   auto native = make_random_data<uint16_t>(4242, 8191, 4, 0x30FD, 11);
+   std::vector<uint16_t> swapped(native.size());
+
+   for (size_t i = 0; i < native.size(); ++i) {
+      swapped[i] = mmoore::swap_always(native[i]);
+   }
+
+   CAPTURE(keyword);
+
+   MonkeyMoore<uint16_t> reference(keyword, '*');
+   reference.set_algorithm(SearchAlgorithm::BoyerMoore);
+
+   auto expected = reference.search(native.data(), native.size());
+   REQUIRE(!expected.empty());
+
+   auto algorithm = GENERATE(
+      SearchAlgorithm::BoyerMoore, 
+      SearchAlgorithm::QGram, 
+      SearchAlgorithm::BitParallel, 
+      SearchAlgorithm::Vectorized);
+
+   auto tier = GENERATE(
+      mmoore::InstructionSet::Scalar,
+      mmoore::InstructionSet::SSE2,
+      mmoore::InstructionSet::AVX2,
+      mmoore::InstructionSet::AVX512);
+
+   MonkeyMoore<uint16_t> searcher(keyword, '*');
+   searcher.set_algorithm(algorithm);
+   searcher.set_instruction_set(tier);
+   searcher.set_byte_order(mmoore::foreign_endianness);
+
+   REQUIRE(searcher.search(swapped.data(), swapped.size()) == expected);
+
+   std::vector<uint8_t> deltas;
+   MonkeyMoore<uint16_t>::compute_delta_stream(swapped.data(), swapped.size(), deltas, mmoore::foreign_endianness);
+
+   REQUIRE(searcher.search_delta_stream(swapped.data(), deltas.data(), swapped.size()) == expected);
+}
+
+TEST_CASE("Search algorithm: match sinks", "[core][relative][sink]") {
+   /**
+    * Every strategy hands the sink the same matches it returns, in increasing offset order.
+    */
+   std::u32string pattern = GENERATE(as<std::u32string>{}, U"abacab", U"ab*cab", U"AbcaB");
+   std::vector<CharType> keyword = to_vector(pattern);
+
+   auto data = make_random_data<uint16_t>(999, 8191, 4, 0x3040);
+
+   auto algorithm = GENERATE(
+      SearchAlgorithm::BoyerMoore, 
+      SearchAlgorithm::QGram, 
+      SearchAlgorithm::BitParallel, 
+      SearchAlgorithm::Vectorized);
+
+   CAPTURE(keyword);
+
+   MonkeyMoore<uint16_t> searcher(keyword, '*');
+   searcher.set_algorithm(algorithm);
+
+   auto expected = searcher.search(data.data(), data.size());
+   REQUIRE(!expected.empty());
+
+   SECTION("Callable sink") {
+      std::vector<MonkeyMoore<uint16_t>::result_type> streamed;
+      searcher.search(data.data(), data.size(), [&](const auto &match) { streamed.push_back(match); });
+
+      REQUIRE(streamed == expected);
+   }
+
+   SECTION("Counting sink") {
+      MatchCounter counter;
+      searcher.search(data.data(), data.size(), counter);
+
+      CHECK(counter.count == expected.size());
+   }
+
+   SECTION("Difference stream") {
+      std::vector<uint8_t> deltas;
+      MonkeyMoore<uint16_t>::compute_delta_stream(data.data(), data.size(), deltas);
+
+      MatchCounter counter;
+      std::vector<MonkeyMoore<uint16_t>::result_type> streamed;
+
+      searcher.search_delta_stream(data.data(), deltas.data(), data.size(), [&](const auto &match) { 
+         streamed.push_back(match); 
+         counter(match);
+      });
+
+      REQUIRE(streamed == expected);
+      CHECK(counter.count == expected.size());
+   }
+}
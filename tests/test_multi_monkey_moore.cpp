@@ -0,0 +1,234 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "mmoore/multi_monkey_moore.hpp"
+#include "common.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+/**
+ * Flattens the results of individual searches for each keyword, in the
+ * order reported by MultiMonkeyMoore (offset, then keyword id).
+ */
+template <class Ty>
+static std::vector<typename MultiMonkeyMoore<Ty>::result_type> search_individually(
+   const std::vector<std::vector<CharType>> &keywords,
+   const std::vector<Ty> &data
+) {
+   std::vector<typename MultiMonkeyMoore<Ty>::result_type> results;
+
+   for (uint32_t keyword_id = 0; keyword_id < keywords.size(); ++keyword_id) {
+      MonkeyMoore<Ty> searcher(keywords[keyword_id], '*');
+
+      for (const auto &[offset, encoding] : searcher.search(data.data(), data.size())) {
+         results.push_back({offset, keyword_id, encoding});
+      }
+   }
+
+   std::sort(results.begin(), results.end(), [](const auto &a, const auto &b) {
+      return a.offset != b.offset ? a.offset < b.offset : a.keyword_id < b.keyword_id;
+   });
+
+   return results;
+}
+
+template <class Ty>
+static void require_same_results(
+   const std::vector<typename MultiMonkeyMoore<Ty>::result_type> &actual,
+   const std::vector<typename MultiMonkeyMoore<Ty>::result_type> &expected
+) {
+   REQUIRE(actual.size() == expected.size());
+
+   for (size_t i = 0; i < actual.size(); ++i) {
+      CAPTURE(i);
+      CHECK(actual[i].offset == expected[i].offset);
+      CHECK(actual[i].keyword_id == expected[i].keyword_id);
+      CHECK(actual[i].encoding == expected[i].encoding);
+   }
+}
+
+TEST_CASE("Multi-keyword search", "[core][relative][multi-keyword]") {
+   // the scalar tier is forced where the automaton itself is under test, since
+   // small keyword sets are otherwise scanned one keyword at a time
+   SECTION("Reports the keyword id and equivalency map of each match") {
+      std::vector<uint8_t> data = to_vector("the potion costs less than the ether");
+      shift_alpha_values(data, 5, 5);
+
+      MultiMonkeyMoore<uint8_t> searcher({
+         to_vector(U"ether"),
+         to_vector(U"potion"),
+         to_vector(U"elixir")
+      });
+      searcher.set_instruction_set(mmoore::InstructionSet::Scalar);
+
+      auto results = searcher.search(data.data(), data.size());
+      REQUIRE(results.size() == 2);
+
+      CHECK(results[0].offset == 4);
+      CHECK(results[0].keyword_id == 1);
+      CHECK(searcher.make_equivalency_map(results[0].encoding).at('a') == 'a' + 5);
+      CHECK(searcher.make_equivalency_map(results[0].encoding).at('A') == 'A' + 5);
+
+      CHECK(results[1].offset == 31);
+      CHECK(results[1].keyword_id == 0);
+      CHECK(searcher.make_equivalency_map(results[1].encoding).at('a') == 'a' + 5);
+   }
+
+   SECTION("Reports every keyword sharing the same relative pattern") {
+      // "abc" and "bcd" have identical differences but different equivalency maps
+      std::vector<uint8_t> data = {0x10, 0x20, 0x21, 0x22, 0x30};
+
+      MultiMonkeyMoore<uint8_t> searcher({to_vector(U"abc"), to_vector(U"bcd")});
+      searcher.set_instruction_set(mmoore::InstructionSet::Scalar);
+
+      auto results = searcher.search(data.data(), data.size());
+      REQUIRE(results.size() == 2);
+
+      CHECK(results[0].offset == 1);
+      CHECK(results[0].keyword_id == 0);
+      CHECK(searcher.make_equivalency_map(results[0].encoding).at('a') == 0x20);
+
+      CHECK(results[1].offset == 1);
+      CHECK(results[1].keyword_id == 1);
+      CHECK(searcher.make_equivalency_map(results[1].encoding).at('a') == 0x1F);
+   }
+
+   SECTION("Results match individual searches") {
+      // keywords that are prefixes/suffixes of each other, repeat themselves, and
+      // a few that can't go through the automaton (wildcards, case changes)
+      std::vector<std::vector<CharType>> keywords = {
+         to_vector(U"abacab"),
+         to_vector(U"acab"),
+         to_vector(U"aba"),
+         to_vector(U"bacabac"),
+         to_vector(U"dcba"),
+         to_vector(U"aaaa"),
+         to_vector(U"ab*cab"),
+         to_vector(U"Abacab")
+      };
+
+      auto data8 = make_random_data<uint8_t>(4242, 4099, 4, 0x40);
+      auto data16 = make_random_data<uint16_t>(4242, 4099, 4, 0x3040);
+
+      // small keyword sets are scanned with the vectorized kernels, the scalar tier
+      // forces them through the automaton
+      auto instruction_set = GENERATE(mmoore::InstructionSet::Automatic, mmoore::InstructionSet::Scalar);
+      CAPTURE(mmoore::to_string(instruction_set));
+
+      MultiMonkeyMoore<uint8_t> searcher8(keywords, '*');
+      MultiMonkeyMoore<uint16_t> searcher16(keywords, '*');
+
+      searcher8.set_instruction_set(instruction_set);
+      searcher16.set_instruction_set(instruction_set);
+
+      auto expected8 = search_individually(keywords, data8);
+      REQUIRE(!expected8.empty());
+
+      require_same_results<uint8_t>(searcher8.search(data8.data(), data8.size()), expected8);
+      require_same_results<uint16_t>(
+         searcher16.search(data16.data(), data16.size()),
+         search_individually(keywords, data16));
+
+      // matches handed to a sink are the same, in no particular order
+      std::vector<MultiMonkeyMoore<uint8_t>::result_type> streamed;
+      searcher8.search(data8.data(), data8.size(), [&](const auto &match) { streamed.push_back(match); });
+
+      std::sort(streamed.begin(), streamed.end(), [](const auto &a, const auto &b) {
+         return a.offset != b.offset ? a.offset < b.offset : a.keyword_id < b.keyword_id;
+      });
+
+      require_same_results<uint8_t>(streamed, expected8);
+
+      MatchCounter counter;
+      searcher8.search(data8.data(), data8.size(), counter);
+
+      CHECK(counter.count == expected8.size());
+   }
+
+   SECTION("Keywords with wildcards and case changes are anchored in the automaton") {
+      // anchors at the start, middle and end of the keyword, leading and trailing wildcards,
+      // case changes, and keywords with no adjacent literals (searched individually)
+      std::vector<std::vector<CharType>> keywords = {
+         to_vector(U"ab*cab"),
+         to_vector(U"*bacab"),
+         to_vector(U"a*b*cabd"),
+         to_vector(U"abac**"),
+         to_vector(U"**ab**"),
+         to_vector(U"Abacab"),
+         to_vector(U"aBCDa"),
+         to_vector(U"a*b*c"),
+         to_vector(U"cabac")
+      };
+
+      auto data8 = make_random_data<uint8_t>(1234, 4099, 4, 0x40);
+      auto data16 = make_random_data<uint16_t>(1234, 4099, 4, 0x3040);
+
+      // matches whose rest runs up to (or would run past) either end of the data
+      plant_keyword(data8, 0, keywords[1], 0x40);
+      plant_keyword(data16, 0, keywords[1], 0x3040);
+      plant_keyword(data8, data8.size() - 6, keywords[3], 0x40);
+      plant_keyword(data16, data16.size() - 6, keywords[3], 0x3040);
+
+      auto instruction_set = GENERATE(mmoore::InstructionSet::Automatic, mmoore::InstructionSet::Scalar);
+      CAPTURE(mmoore::to_string(instruction_set));
+
+      MultiMonkeyMoore<uint8_t> searcher8(keywords, '*');
+      MultiMonkeyMoore<uint16_t> searcher16(keywords, '*');
+
+      searcher8.set_instruction_set(instruction_set);
+      searcher16.set_instruction_set(instruction_set);
+
+      auto expected8 = search_individually(keywords, data8);
+      auto expected16 = search_individually(keywords, data16);
+
+      REQUIRE(!expected8.empty());
+      REQUIRE(!expected16.empty());
+      CHECK(expected8.front().offset == 0);
+      CHECK(expected8.back().offset == data8.size() - 6);
+
+      require_same_results<uint8_t>(searcher8.search(data8.data(), data8.size()), expected8);
+      require_same_results<uint16_t>(searcher16.search(data16.data(), data16.size()), expected16);
+   }
+
+   SECTION("Searches data in the foreign byte order") {
+      std::vector<std::vector<CharType>> keywords = {
+         to_vector(U"abacab"),
+         to_vector(U"acab"),
+         to_vector(U"bacabac"),
+         to_vector(U"ab*cab")
+      };
+
+      // values straddle a 256 boundary, so the unswapped bytes don't match by accident
+      auto native = make_random_data<uint16_t>(777, 4099, 4, 0x30FE);
+      std::vector<uint16_t> swapped(native.size());
+
+      for (size_t i = 0; i < native.size(); ++i) {
+         swapped[i] = mmoore::swap_always(native[i]);
+      }
+
+      auto instruction_set = GENERATE(mmoore::InstructionSet::Automatic, mmoore::InstructionSet::Scalar);
+      CAPTURE(mmoore::to_string(instruction_set));
+
+      MultiMonkeyMoore<uint16_t> searcher(keywords, '*');
+      searcher.set_instruction_set(instruction_set);
+      searcher.set_byte_order(mmoore::foreign_endianness);
+
+      auto expected = search_individually(keywords, native);
+      REQUIRE(!expected.empty());
+
+      require_same_results<uint16_t>(searcher.search(swapped.data(), swapped.size()), expected);
+   }
+
+   SECTION("Differences wrap around the data type") {
+      std::vector<uint8_t> data = {0xFE, 0xFF, 0x00, 0x01, 0x02};
+
+      MultiMonkeyMoore<uint8_t> searcher({to_vector(U"abcde"), to_vector(U"xyz")});
+      searcher.set_instruction_set(mmoore::InstructionSet::Scalar);
+
+      auto results = searcher.search(data.data(), data.size());
+
+      // the relative differences match, but the exact comparison rejects the overflow
+      require_same_results<uint8_t>(results, search_individually(
+         {to_vector(U"abcde"), to_vector(U"xyz")}, data));
+   }
+}
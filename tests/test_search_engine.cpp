@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "mmoore/search_engine.hpp"
+#include "mmoore/result_groups.hpp"
+#include "mmoore/cpu_topology.hpp"
 #include "common.hpp"
 
 #include <catch2/catch_test_macros.hpp>
@@ -8,8 +10,10 @@
 #include <catch2/generators/catch_generators.hpp>
 #include <filesystem>
 #include <vector>
+#include <set>
 #include <fstream>
 #include <cstdint>
+#include <cstring>
 
 static std::vector<uint16_t> to_big_endian_bytes(const std::vector<uint16_t> &source_data) {
    std::vector<uint16_t> big_endian_data;
@@ -156,6 +160,33 @@ TEST_CASE("Search engine: 16-bit relative search correctness", "[search-engine][
 
       REQUIRE_THAT(results, Catch::Matchers::Equals(expected_results));
    }
+
+   SECTION("Finds a match starting on the last byte of a block") {
+      int num_threads = GENERATE(1, 4);
+      const int block_size = 16;
+
+      // "text" (little endian) on an odd offset, so its values start on the block's last byte
+      const std::vector<uint8_t> keyword_bytes = { 0x94, 0x10, 0x85, 0x10, 0x98, 0x10, 0x94, 0x10 };
+      std::vector<uint8_t> bytes(48, 0);
+      std::copy(keyword_bytes.begin(), keyword_bytes.end(), bytes.begin() + block_size - 1);
+
+      std::vector<uint16_t> odd_file_data(bytes.size() / sizeof(uint16_t));
+      std::memcpy(odd_file_data.data(), bytes.data(), bytes.size());
+
+      config.preferred_num_threads = num_threads;
+      config.preferred_search_block_size = block_size;
+
+      TempFile temp_file(odd_file_data);
+      config.file_path = temp_file.path;
+
+      INFO(" Threads: " << num_threads);
+
+      mmoore::SearchEngine<uint16_t> engine(config);
+      auto results = engine.run([](int, const mmoore::SearchStep){}, abort, false);
+
+      REQUIRE(results.size() == 1);
+      CHECK(results[0].offset == block_size - 1);
+   }
 }
 
 TEST_CASE("Search engine: 8-bit relative search preview generation", "[search-engine][8-bit][preview]") {
@@ -195,7 +226,7 @@ TEST_CASE("Search engine: 8-bit relative search preview generation", "[search-en
 
       REQUIRE(results.size() == 1);
 
-      auto &[offset, values_map, preview] = results[0];
+      auto &[offset, values_map, preview, keyword_id] = results[0];
       CHECK(offset == 0);
       CHECK(preview == "match#me");
    }
@@ -212,7 +243,7 @@ TEST_CASE("Search engine: 8-bit relative search preview generation", "[search-en
 
       REQUIRE(results.size() == 1);
 
-      auto &[offset, values_map, preview] = results[0];
+      auto &[offset, values_map, preview, keyword_id] = results[0];
       CHECK(offset == 13);
       CHECK(preview == "the#final");
    }
@@ -229,7 +260,7 @@ TEST_CASE("Search engine: 8-bit relative search preview generation", "[search-en
 
       REQUIRE(results.size() == 1);
 
-      auto &[offset, values_map, preview] = results[0];
+      auto &[offset, values_map, preview, keyword_id] = results[0];
       CHECK(offset == 10);
       CHECK(preview == "nderstandin");
    }
@@ -272,7 +303,7 @@ TEST_CASE("Search engine: 16-bit relative search preview generation", "[search-e
 
       REQUIRE(results.size() == 1);
 
-      auto &[offset, values_map, preview] = results[0];
+      auto &[offset, values_map, preview, keyword_id] = results[0];
       CHECK(offset == 0);
       CHECK(preview == "catch#me");
    }
@@ -289,7 +320,7 @@ TEST_CASE("Search engine: 16-bit relative search preview generation", "[search-e
 
       REQUIRE(results.size() == 1);
 
-      auto &[offset, values_map, preview] = results[0];
+      auto &[offset, values_map, preview, keyword_id] = results[0];
       CHECK(offset == 26);
       CHECK(preview == "inal#step");
    }
@@ -320,7 +351,7 @@ TEST_CASE("Search engine: character sequence relative search preview generation"
 
       REQUIRE(results.size() == 1);
 
-      auto &[offset, values_map, preview] = results[0];
+      auto &[offset, values_map, preview, keyword_id] = results[0];
       CHECK(offset == 4);
       CHECK(preview == "あした#わたしたちは#にわに");
    }
@@ -341,7 +372,7 @@ TEST_CASE("Search engine: character sequence relative search preview generation"
 
       REQUIRE(results.size() == 1);
 
-      auto &[offset, values_map, preview] = results[0];
+      auto &[offset, values_map, preview, keyword_id] = results[0];
       CHECK(offset == 8);
       CHECK(preview == "あした#わたしたちは#にわに");
    }
@@ -445,3 +476,818 @@ TEST_CASE("Search engine: custom wildcard support", "[search-engine][wildcard]")
       CHECK(results.size() == 7);
    }
 }
+
+TEST_CASE("Search engine: multi-keyword search", "[search-engine][multi-keyword]") {
+   TempFile<uint8_t> temp_file("#####the theater's theatrical theatergoer thanked the theatrical theater's theatrics####", 0x10);
+
+   mmoore::SearchConfig config;
+   config.file_path = temp_file.path;
+   config.keywords = {to_vector(U"theater"), to_vector(U"theatrical"), to_vector(U"thanked")};
+   config.preferred_preview_width = 25;
+
+   std::atomic<bool> abort{false};
+
+   SECTION("Finds all keywords in a single pass") {
+      int num_threads = GENERATE(1, 4);
+
+      // 16 splits keywords across blocks, 128 is larger than the file
+      int block_size = GENERATE(16, 128);
+
+      config.preferred_num_threads = num_threads;
+      config.preferred_search_block_size = block_size;
+
+      INFO(" Threads: " << num_threads << ", Block size: " << block_size);
+
+      mmoore::SearchEngine<uint8_t> engine(config);
+      auto results = engine.run([](int, const mmoore::SearchStep){}, abort, true);
+
+      const std::vector<std::pair<uint64_t, uint32_t>> expected = {
+         {  9, 0 }, { 19, 1 }, { 30, 0 }, { 42, 2 }, { 54, 1 }, { 65, 0 }
+      };
+
+      REQUIRE(results.size() == expected.size());
+
+      for (size_t i = 0; i < expected.size(); ++i) {
+         CAPTURE(i);
+         CHECK(results[i].offset == expected[i].first);
+         CHECK(results[i].keyword_id == expected[i].second);
+         CHECK(results[i].values_map->at('a') == 'a' + 0x10);
+      }
+
+      // previews are centered on the length of the matched keyword
+      CHECK(results[3].preview == "atergoer#thanked#the#thea");
+   }
+}
+
+TEST_CASE("Search engine: delta-transform pipeline", "[search-engine][delta-transform]") {
+   TempFile<uint8_t> temp_file("#####the theater's theatrical theatergoer thanked the theatrical theater's theatrics####", 0x10);
+
+   mmoore::SearchConfig config;
+   config.file_path = temp_file.path;
+   config.preferred_preview_width = 25;
+
+   std::atomic<bool> abort{false};
+
+   // keywords without wildcards, with wildcards and a case change, searched alone and together
+   auto keywords = GENERATE(
+      std::vector<std::vector<CharType>>{ to_vector(U"theater") },
+      std::vector<std::vector<CharType>>{ to_vector(U"th*at**") },
+      std::vector<std::vector<CharType>>{ to_vector(U"Theatrics") },
+      std::vector<std::vector<CharType>>{ to_vector(U"theater"), to_vector(U"th*at"), to_vector(U"thanked") });
+
+   if (keywords.size() == 1) {
+      config.keyword = keywords[0];
+   }
+   else {
+      config.keywords = keywords;
+   }
+
+   int block_size = GENERATE(16, 23, 128);
+   config.preferred_search_block_size = block_size;
+
+   INFO(" Keywords: " << keywords.size() << ", Block size: " << block_size);
+
+   auto run_pipeline = [&](mmoore::SearchPipeline pipeline) {
+      config.pipeline = pipeline;
+
+      mmoore::SearchEngine<uint8_t> engine(config);
+      return engine.run([](int, const mmoore::SearchStep){}, abort, true);
+   };
+
+   auto expected = run_pipeline(mmoore::SearchPipeline::Direct);
+   auto results = run_pipeline(mmoore::SearchPipeline::DeltaTransform);
+
+   REQUIRE(!expected.empty());
+   REQUIRE(results.size() == expected.size());
+
+   for (size_t i = 0; i < expected.size(); ++i) {
+      CAPTURE(i);
+      CHECK(results[i].offset == expected[i].offset);
+      CHECK(results[i].keyword_id == expected[i].keyword_id);
+      CHECK(*results[i].values_map == *expected[i].values_map);
+      CHECK(results[i].preview == expected[i].preview);
+   }
+}
+
+TEST_CASE("Search engine: file access modes", "[search-engine][file-access]") {
+   const std::string text = "#####the theater's theatrical theatergoer thanked the theatrical theater's theatrics####";
+
+   std::atomic<bool> abort{false};
+
+   // previews near both ends of the file read past the mapping's bounds if clamped wrongly
+   auto keyword = GENERATE(as<std::u32string>{}, U"theater", U"th*at**", U"theatrics");
+   int block_size = GENERATE(16, 128);
+
+   INFO(" Block size: " << block_size);
+
+   SECTION("8-bit results match between mapped and stream reads") {
+      TempFile<uint8_t> temp_file(text, 0x10);
+
+      mmoore::SearchConfig config;
+      config.file_path = temp_file.path;
+      config.keyword = to_vector(keyword);
+      config.preferred_preview_width = 25;
+      config.preferred_search_block_size = block_size;
+
+      auto run_with = [&](mmoore::FileAccess file_access) {
+         config.file_access = file_access;
+
+         mmoore::SearchEngine<uint8_t> engine(config);
+         return engine.run([](int, const mmoore::SearchStep){}, abort, true);
+      };
+
+      auto expected = run_with(mmoore::FileAccess::Stream);
+
+      REQUIRE(!expected.empty());
+      REQUIRE(run_with(mmoore::FileAccess::MemoryMapped) == expected);
+   }
+
+   SECTION("16-bit big-endian results match between mapped and stream reads") {
+      std::vector<uint16_t> data(text.size());
+      std::transform(text.begin(), text.end(), data.begin(), [](char c) {
+         return mmoore::swap_on_little_endian(static_cast<uint16_t>(c + 0x3000));
+      });
+
+      TempFile<uint16_t> temp_file(data);
+
+      mmoore::SearchConfig config;
+      config.file_path = temp_file.path;
+      config.keyword = to_vector(keyword);
+      config.endianness = mmoore::Endianness::Big;
+      config.preferred_preview_width = 25;
+      config.preferred_search_block_size = block_size;
+
+      auto run_with = [&](mmoore::FileAccess file_access) {
+         config.file_access = file_access;
+
+         mmoore::SearchEngine<uint16_t> engine(config);
+         return engine.run([](int, const mmoore::SearchStep){}, abort, true);
+      };
+
+      auto expected = run_with(mmoore::FileAccess::Stream);
+
+      REQUIRE(!expected.empty());
+      REQUIRE(run_with(mmoore::FileAccess::MemoryMapped) == expected);
+   }
+}
+
+TEST_CASE("Search engine: consecutive searches on the shared workers", "[search-engine][threads]") {
+   auto temp_file = make_repeated_text_file<uint8_t>(64, 0x10);
+
+   auto config = make_search_config(temp_file);
+   config.keywords = {to_vector(U"theater"), to_vector(U"th*at"), to_vector(U"thanked")};
+   config.preferred_search_block_size = 97;
+
+   config.preferred_num_threads = 1;
+   auto expected = mmoore::SearchEngine<uint8_t>(config).run([](int, const mmoore::SearchStep){}, never_abort);
+
+   REQUIRE(expected.size() == 64 * 10);
+
+   // more threads than blocks or cores, and the same engine run repeatedly
+   int num_threads = GENERATE(2, 3, 8, 64);
+   config.preferred_num_threads = num_threads;
+
+   INFO(" Threads: " << num_threads);
+
+   mmoore::SearchEngine<uint8_t> engine(config);
+
+   for (int run = 0; run < 3; ++run) {
+      std::vector<int> progress_history;
+      auto results = engine.run([&](int percent, const mmoore::SearchStep) {
+         progress_history.push_back(percent);
+      }, never_abort);
+
+      REQUIRE(results.size() == expected.size());
+
+      for (size_t i = 0; i < expected.size(); ++i) {
+         CAPTURE(i);
+         CHECK(results[i].offset == expected[i].offset);
+         CHECK(results[i].keyword_id == expected[i].keyword_id);
+      }
+
+      CHECK(std::is_sorted(progress_history.begin(), progress_history.end()));
+      CHECK(progress_history.back() == 100);
+   }
+}
+
+TEST_CASE("Search engine: buffer reuse statistics", "[search-engine][stats]") {
+   auto temp_file = make_repeated_text_file<uint8_t>(32, 0x10);
+
+   auto config = make_search_config(temp_file);
+   config.keyword = to_vector(U"theater");
+   config.preferred_search_block_size = 64;
+
+   SECTION("Stream reads allocate one buffer per read-ahead slot") {
+      config.file_access = mmoore::FileAccess::Stream;
+      config.preferred_num_threads = GENERATE(1, 4);
+      config.read_ahead_depth = GENERATE(0, 2);
+
+      mmoore::SearchEngine<uint8_t> engine(config);
+      auto results = engine.run([](int, const mmoore::SearchStep){}, never_abort);
+
+      const uint64_t slots_per_worker = static_cast<uint64_t>(config.read_ahead_depth) + 1;
+
+      REQUIRE(results.size() == 32 * 3);
+      CHECK(engine.stats().buffer_allocations >= 1);
+      CHECK(engine.stats().buffer_allocations <= config.preferred_num_threads * slots_per_worker);
+      CHECK(engine.stats().buffer_bytes_allocated % 4096 == 0);
+   }
+
+   SECTION("Mapped reads don't allocate read buffers") {
+      config.file_access = mmoore::FileAccess::MemoryMapped;
+      config.preferred_num_threads = 1;
+
+      mmoore::SearchEngine<uint8_t> engine(config);
+      auto results = engine.run([](int, const mmoore::SearchStep){}, never_abort);
+
+      REQUIRE(results.size() == 32 * 3);
+
+#if defined(__unix__) || defined(__APPLE__)
+      CHECK(engine.stats().buffer_allocations == 0);
+      CHECK(engine.stats().peak_rss_bytes > 0);
+#endif
+   }
+}
+
+TEST_CASE("Search engine: read-ahead", "[search-engine][read-ahead]") {
+   auto temp_file = make_repeated_text_file<uint16_t>(32, 0x3000, mmoore::Endianness::Big);
+
+   auto config = make_search_config(temp_file);
+   config.keyword = to_vector(U"theater");
+   config.endianness = mmoore::Endianness::Big;
+   config.preferred_search_block_size = 96;
+
+   auto run_with = [&](mmoore::SearchEngine<uint16_t> &engine) {
+      return engine.run([](int, const mmoore::SearchStep){}, never_abort, true);
+   };
+
+   config.file_access = mmoore::FileAccess::MemoryMapped;
+   mmoore::SearchEngine<uint16_t> mapped_engine(config);
+   auto expected = run_with(mapped_engine);
+
+   REQUIRE(expected.size() == 32 * 3);
+   CHECK(mapped_engine.stats().read_ahead_backend == mmoore::ReadAheadBackend::None);
+
+   // results don't depend on how many blocks are in flight, or on who reads them
+   auto backend = GENERATE(
+      mmoore::ReadAheadBackend::Automatic, 
+      mmoore::ReadAheadBackend::IoUring, 
+      mmoore::ReadAheadBackend::Thread, 
+      mmoore::ReadAheadBackend::None);
+   int depth = GENERATE(0, 1, 4, 64);
+   int num_threads = GENERATE(1, 3);
+
+   INFO(" Backend: " << static_cast<int>(backend) << ", depth: " << depth << ", threads: " << num_threads);
+
+   config.file_access = mmoore::FileAccess::Stream;
+   config.read_ahead_backend = backend;
+   config.read_ahead_depth = depth;
+   config.preferred_num_threads = num_threads;
+
+   mmoore::SearchEngine<uint16_t> engine(config);
+   REQUIRE(run_with(engine) == expected);
+
+   const auto &stats = engine.stats();
+   CHECK(stats.compute_time.count() > 0);
+
+   if (depth == 0 || backend == mmoore::ReadAheadBackend::None) {
+      CHECK(stats.read_ahead_backend == mmoore::ReadAheadBackend::None);
+   }
+   else if (backend == mmoore::ReadAheadBackend::Thread) {
+      CHECK(stats.read_ahead_backend == mmoore::ReadAheadBackend::Thread);
+   }
+   else {
+#if defined(__linux__)
+      CHECK(stats.read_ahead_backend != mmoore::ReadAheadBackend::None);
+#else
+      CHECK(stats.read_ahead_backend == mmoore::ReadAheadBackend::Thread);
+#endif
+   }
+}
+
+TEST_CASE("Search engine: direct reads", "[search-engine][direct-io]") {
+   // block boundaries (and the overlap behind them) fall inside and across the aligned reads
+   int block_size = GENERATE(100, 511, 4096, 5000);
+   auto backend = GENERATE(mmoore::ReadAheadBackend::Automatic, mmoore::ReadAheadBackend::Thread);
+   int depth = GENERATE(0, 2);
+
+   INFO(" Block size: " << block_size << ", backend: " << static_cast<int>(backend) << ", depth: " << depth);
+
+   auto configure = [&](mmoore::SearchConfig &config) {
+      config.keyword = to_vector(U"theatergoer");
+      config.preferred_preview_width = 25;
+      config.preferred_search_block_size = block_size;
+      config.read_ahead_backend = backend;
+      config.read_ahead_depth = depth;
+   };
+
+   SECTION("8-bit results match mapped reads") {
+      auto temp_file = make_repeated_text_file<uint8_t>(256, 0x10);
+
+      auto config = make_search_config(temp_file);
+      configure(config);
+
+      mmoore::SearchEngine<uint8_t> mapped_engine(config);
+      auto expected = mapped_engine.run([](int, const mmoore::SearchStep){}, never_abort, true);
+
+      config.file_access = mmoore::FileAccess::Direct;
+
+      mmoore::SearchEngine<uint8_t> direct_engine(config);
+      auto results = direct_engine.run([](int, const mmoore::SearchStep){}, never_abort, true);
+
+      REQUIRE(expected.size() == 256);
+      REQUIRE(results == expected);
+   }
+
+   SECTION("16-bit big-endian results match mapped reads") {
+      auto temp_file = make_repeated_text_file<uint16_t>(256, 0x3000, mmoore::Endianness::Big);
+
+      auto config = make_search_config(temp_file);
+      config.endianness = mmoore::Endianness::Big;
+      configure(config);
+
+      mmoore::SearchEngine<uint16_t> mapped_engine(config);
+      auto expected = mapped_engine.run([](int, const mmoore::SearchStep){}, never_abort, true);
+
+      config.file_access = mmoore::FileAccess::Direct;
+
+      mmoore::SearchEngine<uint16_t> direct_engine(config);
+      auto results = direct_engine.run([](int, const mmoore::SearchStep){}, never_abort, true);
+
+      REQUIRE(expected.size() == 256);
+      REQUIRE(results == expected);
+   }
+}
+
+TEST_CASE("Search engine: files larger than 4 GB", "[search-engine][large-file]") {
+   // sparse file, so only the planted keywords take up disk space
+   const auto path = std::filesystem::temp_directory_path() / "mmoore_test_large.bin";
+   const uint64_t four_gb = uint64_t(1) << 32;
+   const uint64_t block_size = 1 << 20;
+
+   // across the 4 GB boundary, across a block boundary past it, an odd offset, near the end
+   const std::vector<uint64_t> planted_offsets = {
+      four_gb - 4,
+      four_gb + 3 * block_size - 6,
+      four_gb + 0x1234567,
+      four_gb + (uint64_t(64) << 20) - 40
+   };
+
+   const uint64_t file_size = four_gb + (uint64_t(64) << 20) - 11;
+   const std::string keyword = "theater";
+
+   {
+      std::ofstream file(path, std::ios::binary);
+
+      for (auto offset : planted_offsets) {
+         file.seekp(static_cast<std::streamoff>(offset));
+         file.write(keyword.data(), static_cast<std::streamsize>(keyword.size()));
+      }
+   }
+
+   std::filesystem::resize_file(path, file_size);
+
+   mmoore::SearchConfig config;
+   config.file_path = path;
+   config.keyword = to_vector(U"theater");
+   config.preferred_search_block_size = block_size;
+   config.file_access = GENERATE(mmoore::FileAccess::MemoryMapped, mmoore::FileAccess::Stream);
+
+   std::atomic<bool> abort{false};
+
+   SECTION("8-bit offsets are exact past 4 GB") {
+      mmoore::SearchEngine<uint8_t> engine(config);
+      auto results = engine.run([](int, const mmoore::SearchStep){}, abort, true);
+
+      REQUIRE(results.size() == planted_offsets.size());
+
+      for (size_t i = 0; i < results.size(); ++i) {
+         CHECK(results[i].offset == planted_offsets[i]);
+         CHECK(results[i].preview.find("theater") != std::string::npos);
+      }
+   }
+
+   std::filesystem::remove(path);
+}
+
+TEST_CASE("Search engine: sparse files", "[search-engine][sparse]") {
+   const auto path = std::filesystem::temp_directory_path() / "mmoore_test_sparse.bin";
+   const uint64_t extent_size = 64 << 10;
+
+   // three data extents separated by holes (allocated in whole file system blocks)
+   const uint64_t extent_a = 1 << 20;
+   const uint64_t extent_b = 4 << 20;
+   const uint64_t extent_c = 9 << 20;
+   const uint64_t file_size = 16 << 20;
+
+   {
+      std::ofstream file(path, std::ios::binary);
+      const std::vector<char> filler(extent_size, 0x01);
+
+      for (auto offset : { extent_a, extent_b, extent_c }) {
+         file.seekp(static_cast<std::streamoff>(offset));
+         file.write(filler.data(), static_cast<std::streamsize>(filler.size()));
+      }
+
+      // the last bytes of b run into the hole after it, the first bytes of c follow a hole
+      const char pattern[] = { 0x45, 0x43 };
+
+      file.seekp(static_cast<std::streamoff>(extent_a + 1000));
+      file.write("theater", 7);
+      file.seekp(static_cast<std::streamoff>(extent_b + extent_size - 2));
+      file.write(pattern, 2);
+      file.seekp(static_cast<std::streamoff>(extent_c));
+      file.write(pattern, 2);
+   }
+
+   std::filesystem::resize_file(path, file_size);
+
+   mmoore::SearchConfig config;
+   config.file_path = path;
+   config.preferred_search_block_size = GENERATE(4096, 1 << 20);
+   config.file_access = GENERATE(mmoore::FileAccess::MemoryMapped, mmoore::FileAccess::Stream);
+
+   std::atomic<bool> abort{false};
+
+   auto run_with = [&](bool skip_holes, mmoore::SearchStats &stats) {
+      config.skip_holes = skip_holes;
+
+      mmoore::SearchEngine<uint8_t> engine(config);
+      auto results = engine.run([](int, const mmoore::SearchStep){}, abort);
+      stats = engine.stats();
+
+      std::vector<uint64_t> offsets;
+      for (const auto &result : results) {
+         offsets.push_back(result.offset);
+      }
+
+      return offsets;
+   };
+
+   auto check_search = [&](const std::vector<uint64_t> &expected) {
+      mmoore::SearchStats skipping_stats, reading_stats;
+
+      auto skipping = run_with(true, skipping_stats);
+      auto reading = run_with(false, reading_stats);
+
+      CHECK(skipping == expected);
+      CHECK(reading == expected);
+      CHECK(reading_stats.bytes_skipped == 0);
+
+#if defined(__linux__)
+      CHECK(skipping_stats.bytes_skipped > file_size / 2);
+#endif
+   };
+
+   SECTION("Keywords inside data extents") {
+      config.keyword = to_vector(U"theater");
+      check_search({ extent_a + 1000 });
+   }
+
+   SECTION("Patterns running from data into a hole") {
+      config.is_relative_search = false;
+      config.reference_values = { 0x45, 0x43, 0, 0, 0 };
+      check_search({ extent_b + extent_size - 2 });
+   }
+
+   SECTION("Patterns running from a hole into data") {
+      config.is_relative_search = false;
+      config.reference_values = { 0, 0, 0, 0x45, 0x43 };
+      check_search({ extent_c - 3 });
+   }
+
+   std::filesystem::remove(path);
+}
+
+TEST_CASE("Search engine: automatic block size and threads", "[search-engine][tuning]") {
+   const uint64_t text_size = 1024 * repeated_text.size();
+   auto temp_file = make_repeated_text_file<uint8_t>(1024, 0x10);
+
+   auto config = make_search_config(temp_file);
+   config.keyword = to_vector(U"theater");
+
+   config.preferred_num_threads = 1;
+   config.preferred_search_block_size = text_size;
+
+   mmoore::SearchEngine<uint8_t> reference_engine(config);
+   auto expected = reference_engine.run([](int, const mmoore::SearchStep){}, never_abort, true);
+
+   REQUIRE(expected.size() == 1024 * 3);
+   CHECK(reference_engine.stats().block_size == text_size);
+   CHECK(reference_engine.stats().num_blocks == 1);
+
+   SECTION("Threads default to the physical cores") {
+      config.preferred_num_threads = 0;
+      config.preferred_search_block_size = 0;
+
+      mmoore::SearchEngine<uint8_t> engine(config);
+      REQUIRE(engine.run([](int, const mmoore::SearchStep){}, never_abort, true) == expected);
+
+      const auto &stats = engine.stats();
+      const auto &topology = mmoore::detect_cpu_topology();
+
+      CHECK(stats.num_threads >= 1);
+      CHECK(stats.num_threads <= topology.physical_cores);
+      CHECK(stats.block_size >= 4096);
+      CHECK(stats.block_size <= 8 << 20);
+   }
+
+   SECTION("Small files are split so every thread gets several blocks") {
+      config.preferred_num_threads = GENERATE(2, 4, 8);
+      config.preferred_search_block_size = 0;
+
+      INFO(" Threads: " << config.preferred_num_threads);
+
+      mmoore::SearchEngine<uint8_t> engine(config);
+      REQUIRE(engine.run([](int, const mmoore::SearchStep){}, never_abort, true) == expected);
+
+      const auto &stats = engine.stats();
+
+      // ~80 KB of text, at least 4 KB per block
+      CHECK(stats.num_threads == static_cast<size_t>(config.preferred_num_threads));
+      CHECK(stats.num_blocks >= std::min<uint64_t>(4 * stats.num_threads, text_size / 4096));
+      CHECK(stats.block_size * stats.num_blocks >= text_size);
+   }
+
+   SECTION("Explicit values are kept") {
+      config.preferred_num_threads = 3;
+      config.preferred_search_block_size = 10000;
+
+      mmoore::SearchEngine<uint8_t> engine(config);
+      REQUIRE(engine.run([](int, const mmoore::SearchStep){}, never_abort, true) == expected);
+
+      CHECK(engine.stats().num_threads == 3);
+      CHECK(engine.stats().block_size == 10000);
+      CHECK(engine.stats().num_blocks == (text_size + 9999) / 10000);
+   }
+}
+
+TEST_CASE("Search engine: small files", "[search-engine][small-file]") {
+   auto temp_file = make_repeated_text_file<uint16_t>(1024, 0x20);
+
+   auto config = make_search_config(temp_file);
+   config.keyword = to_vector(U"theatrical");
+
+   config.preferred_num_threads = 4;
+   config.preferred_search_block_size = 4096;
+
+   mmoore::SearchEngine<uint16_t> reference_engine(config);
+   auto expected = reference_engine.run([](int, const mmoore::SearchStep){}, never_abort, true);
+
+   REQUIRE(expected.size() == 1024 * 2);
+   REQUIRE(reference_engine.stats().num_blocks > 1);
+
+   config.preferred_num_threads = 0;
+   config.preferred_search_block_size = 0;
+   config.file_access = GENERATE(mmoore::FileAccess::MemoryMapped, mmoore::FileAccess::Stream);
+
+   INFO(" File access: " << (config.file_access == mmoore::FileAccess::Stream ? "Stream" : "MemoryMapped"));
+
+   SECTION("Searched in one block on the calling thread") {
+      mmoore::SearchEngine<uint16_t> engine(config);
+      REQUIRE(engine.run([](int, const mmoore::SearchStep){}, never_abort, true) == expected);
+
+      const auto &stats = engine.stats();
+
+      CHECK(stats.num_threads == 1);
+      CHECK(stats.num_blocks == 1);
+      CHECK(stats.block_size == 1024 * repeated_text.size() * sizeof(uint16_t));
+
+      // nothing to read ahead of a single block
+      CHECK(stats.read_ahead_backend == mmoore::ReadAheadBackend::None);
+   }
+
+   SECTION("Split over the workers when disabled") {
+      config.inline_search_size = 0;
+
+      mmoore::SearchEngine<uint16_t> engine(config);
+      REQUIRE(engine.run([](int, const mmoore::SearchStep){}, never_abort, true) == expected);
+
+      CHECK(engine.stats().num_blocks > 1);
+   }
+}
+
+TEST_CASE("Search engine: shared equivalency maps", "[search-engine][equivalency-map]") {
+   // the same text in two encodings, 0x10 and 0x30 above ASCII
+   auto temp_file = make_repeated_text_file<uint8_t>(64, [](int i) { return i % 2 == 0 ? 0x10 : 0x30; });
+
+   auto config = make_search_config(temp_file);
+   config.keyword = to_vector(U"theater");
+   config.preferred_search_block_size = 256;
+
+   mmoore::SearchEngine<uint8_t> engine(config);
+   auto results = engine.run([](int, const mmoore::SearchStep){}, never_abort);
+
+   REQUIRE(results.size() == 64 * 3);
+
+   std::set<const void *> distinct_maps;
+
+   for (const auto &result : results) {
+      REQUIRE(result.values_map != nullptr);
+
+      const bool is_first_encoding = (result.offset / repeated_text.size()) % 2 == 0;
+
+      CHECK(result.values_map->at('a') == 'a' + (is_first_encoding ? 0x10 : 0x30));
+      CHECK(result.values_map->at('A') == 'A' + (is_first_encoding ? 0x10 : 0x30));
+
+      distinct_maps.insert(result.values_map.get());
+   }
+
+   // one map per encoding, whichever block found the match
+   CHECK(distinct_maps.size() == 2);
+}
+
+TEST_CASE("Search engine: counting matches", "[search-engine][count]") {
+   // the same text in two encodings, 0x10 and 0x30 above ASCII, the first one twice as often
+   auto temp_file = make_repeated_text_file<uint8_t>(96, [](int i) { return i % 3 != 2 ? 0x10 : 0x30; });
+
+   auto config = make_search_config(temp_file);
+   config.preferred_search_block_size = GENERATE(256, 100000);
+   config.preferred_num_threads = 3;
+   config.pipeline = GENERATE(mmoore::SearchPipeline::Direct, mmoore::SearchPipeline::DeltaTransform);
+
+   auto keywords = GENERATE(
+      std::vector<std::vector<CharType>>{ to_vector(U"theater") },
+      std::vector<std::vector<CharType>>{ to_vector(U"theater"), to_vector(U"th*at"), to_vector(U"thanked") });
+
+   if (keywords.size() == 1) {
+      config.keyword = keywords[0];
+   }
+   else {
+      config.keywords = keywords;
+   }
+
+   INFO(" Keywords: " << keywords.size() << ", Block size: " << config.preferred_search_block_size);
+
+   mmoore::SearchEngine<uint8_t> reference_engine(config);
+   auto expected = reference_engine.run([](int, const mmoore::SearchStep){}, never_abort);
+
+   REQUIRE(!expected.empty());
+   CHECK(reference_engine.stats().matches == expected.size());
+
+   SECTION("Total count") {
+      mmoore::SearchEngine<uint8_t> engine(config);
+
+      CHECK(engine.count([](int, const mmoore::SearchStep){}, never_abort) == expected.size());
+      CHECK(engine.stats().matches == expected.size());
+   }
+
+   SECTION("Counts by encoding") {
+      mmoore::SearchEngine<uint8_t> engine(config);
+      auto counts = engine.count_by_encoding([](int, const mmoore::SearchStep){}, never_abort);
+
+      REQUIRE(counts.size() == 2);
+
+      // most frequent first
+      CHECK(counts[0].values_map->at('a') == 'a' + 0x10);
+      CHECK(counts[1].values_map->at('a') == 'a' + 0x30);
+      CHECK(counts[0].encoding.base == 'a' + 0x10);
+
+      uint64_t expected_first = 0;
+      for (const auto &result : expected) {
+         expected_first += result.values_map->at('a') == 'a' + 0x10 ? 1 : 0;
+      }
+
+      CHECK(counts[0].count == expected_first);
+      CHECK(counts[1].count == expected.size() - expected_first);
+      CHECK(counts[0].count == 2 * counts[1].count);
+   }
+
+   SECTION("Aborted searches count nothing") {
+      std::atomic<bool> aborted{true};
+      mmoore::SearchEngine<uint8_t> engine(config);
+
+      CHECK(engine.count([](int, const mmoore::SearchStep){}, aborted) == 0);
+      CHECK(engine.count_by_encoding([](int, const mmoore::SearchStep){}, aborted).empty());
+   }
+}
+
+TEST_CASE("Search engine: result store", "[search-engine][result-store]") {
+   // the same text in two encodings, 0x30 and 0x10 above ASCII
+   auto temp_file = make_repeated_text_file<uint8_t>(64, [](int i) { return i % 2 == 0 ? 0x30 : 0x10; });
+
+   auto config = make_search_config(temp_file);
+   config.preferred_search_block_size = GENERATE(256, 100000);
+   config.preferred_num_threads = 3;
+
+   auto keywords = GENERATE(
+      std::vector<std::vector<CharType>>{ to_vector(U"theater") },
+      std::vector<std::vector<CharType>>{ to_vector(U"theater"), to_vector(U"th*at"), to_vector(U"thanked") });
+
+   if (keywords.size() == 1) {
+      config.keyword = keywords[0];
+   }
+   else {
+      config.keywords = keywords;
+   }
+
+   INFO(" Keywords: " << keywords.size() << ", Block size: " << config.preferred_search_block_size);
+
+   mmoore::SearchEngine<uint8_t> reference_engine(config);
+   auto expected = reference_engine.run([](int, const mmoore::SearchStep){}, never_abort, true);
+
+   mmoore::SearchEngine<uint8_t> engine(config);
+   auto store = engine.collect([](int, const mmoore::SearchStep){}, never_abort);
+
+   REQUIRE(!expected.empty());
+   REQUIRE(store.size() == expected.size());
+   CHECK(engine.stats().matches == expected.size());
+
+   for (size_t i = 0; i < store.size(); ++i) {
+      CAPTURE(i);
+      CHECK(store.offset(i) == expected[i].offset);
+      CHECK(store.keyword_id(i) == expected[i].keyword_id);
+      CHECK(store.values_map(i) == *expected[i].values_map);
+      CHECK(store.preview(i) == expected[i].preview);
+   }
+
+   // one entry per encoding, numbered in order of appearance
+   REQUIRE(store.num_encodings() == 2);
+   CHECK(store.encoding_id(0) == 0);
+   CHECK(store.encodings()[0].base == 'a' + 0x30);
+   CHECK(store.encodings()[1].base == 'a' + 0x10);
+   CHECK(store.offsets().size() == store.encoding_ids().size());
+
+   for (size_t i = 0; i < store.size(); ++i) {
+      CHECK(store.encoding(i) == store.encodings()[store.encoding_id(i)]);
+      CHECK(&store.values_map(i) == store.equivalency_map_of(store.encoding_id(i)).get());
+   }
+
+   // an offset and an encoding id per result, plus the keyword id for multi-keyword searches
+   const size_t column_bytes = keywords.size() == 1 ? 12 : 16;
+   CHECK(store.memory_usage() >= store.size() * column_bytes);
+   CHECK(store.memory_usage() < store.size() * column_bytes + 4096);
+
+   SECTION("Aborted searches collect nothing") {
+      std::atomic<bool> aborted{true};
+      mmoore::SearchEngine<uint8_t> aborted_engine(config);
+
+      auto empty_store = aborted_engine.collect([](int, const mmoore::SearchStep){}, aborted);
+
+      CHECK(empty_store.empty());
+      CHECK(empty_store.num_encodings() == 0);
+   }
+}
+
+TEST_CASE("Search engine: grouping results by encoding", "[search-engine][group]") {
+   // the same text in three encodings, 0x10 above ASCII on every other copy
+   auto temp_file = make_repeated_text_file<uint8_t>(64, [](int i) {
+      const int shifts[] = { 0x10, 0x20, 0x10, 0x30 };
+      return shifts[i % 4];
+   });
+
+   auto config = make_search_config(temp_file);
+   config.keywords = { to_vector(U"theater"), to_vector(U"thanked") };
+   config.preferred_search_block_size = 256;
+
+   mmoore::SearchEngine<uint8_t> engine(config);
+   auto results = engine.run([](int, const mmoore::SearchStep){}, never_abort);
+
+   REQUIRE(!results.empty());
+
+   // groups by the values of the maps, one result at a time
+   std::vector<std::pair<MonkeyMoore<uint8_t>::equivalency_map, std::vector<uint64_t>>> expected;
+
+   for (const auto &result : results) {
+      auto it = std::find_if(expected.begin(), expected.end(), 
+         [&](const auto &group) { return group.first == *result.values_map; });
+
+      if (it == expected.end()) {
+         expected.push_back({ *result.values_map, {} });
+         it = std::prev(expected.end());
+      }
+
+      it->second.push_back(result.offset);
+   }
+
+   REQUIRE(expected.size() == 3);
+
+   auto check_groups = [&](const std::vector<mmoore::ResultGroup<uint8_t>> &groups) {
+      REQUIRE(groups.size() == expected.size());
+
+      for (size_t i = 0; i < groups.size(); ++i) {
+         CAPTURE(i);
+         CHECK(*groups[i].values_map == expected[i].first);
+         CHECK(groups[i].count == expected[i].second.size());
+         CHECK(groups[i].offsets == expected[i].second);
+         CHECK(groups[i].first_offset == expected[i].second.front());
+         CHECK(results[groups[i].first_index].offset == groups[i].first_offset);
+      }
+
+      CHECK(groups[0].values_map->at('a') == 'a' + 0x10);
+      CHECK(groups[0].count == 2 * groups[1].count);
+   };
+
+   SECTION("Results") {
+      check_groups(mmoore::group_by_encoding(results));
+   }
+
+   SECTION("Result store") {
+      mmoore::SearchEngine<uint8_t> store_engine(config);
+      check_groups(mmoore::group_by_encoding(store_engine.collect([](int, const mmoore::SearchStep){}, never_abort)));
+   }
+
+   SECTION("No results") {
+      CHECK(mmoore::group_by_encoding(std::vector<mmoore::SearchResult<uint8_t>>{}).empty());
+   }
+}